@@ -0,0 +1,74 @@
+/**
+ * @file
+ *
+ * @brief This file contains the implementation of a simple bump allocator.
+ *
+ * @copyright BSD License (see LICENSE.md or https://www.libelektra.org)
+ */
+
+// -- Imports ------------------------------------------------------------------
+
+#include <algorithm>
+#include <cstddef>
+
+#include "arena.hpp"
+
+using std::max;
+
+namespace {
+
+// -- Globals ------------------------------------------------------------------
+
+/** This constant specifies the alignment of every allocation. */
+size_t const alignment = alignof(std::max_align_t);
+
+/** This constant specifies the size of the first block of an arena. */
+size_t const initialBlockSize = 64 * 1024;
+
+} // namespace
+
+// -- Class --------------------------------------------------------------------
+
+/**
+ * @brief This method adds a new memory block to the arena.
+ *
+ * @param size This argument specifies the minimum size of the new block.
+ */
+void Arena::grow(size_t const size) {
+  blockSize = max(max(initialBlockSize, blockSize * 2), size);
+  blocks.emplace_back(new char[blockSize]);
+  used = 0;
+}
+
+/**
+ * @brief This method returns memory for an object of the given size.
+ *
+ * The returned memory is suitably aligned for every fundamental type.
+ *
+ * @param size This number specifies the requested number of bytes.
+ *
+ * @return A pointer to uninitialized memory, which stays valid until the
+ *         destruction of the arena
+ */
+void *Arena::allocate(size_t const size) {
+  size_t const aligned = (size + alignment - 1) & ~(alignment - 1);
+  if (blocks.empty() || blockSize - used < aligned) {
+    grow(aligned);
+  }
+  void *memory = blocks.back().get() + used;
+  used += aligned;
+  return memory;
+}
+
+/**
+ * @brief This method releases all memory returned by the arena.
+ *
+ * The arena keeps its largest block, so that it does not have to allocate
+ * memory again for input of a similar size.
+ */
+void Arena::reset() {
+  if (blocks.size() > 1) {
+    blocks.erase(blocks.begin(), blocks.end() - 1);
+  }
+  used = 0;
+}
@@ -0,0 +1,66 @@
+/**
+ * @file
+ *
+ * @brief This file contains the declaration of a simple bump allocator.
+ *
+ * @copyright BSD License (see LICENSE.md or https://www.libelektra.org)
+ */
+
+#ifndef ELEKTRA_PLUGIN_YAWN_ARENA_HPP
+#define ELEKTRA_PLUGIN_YAWN_ARENA_HPP
+
+// -- Imports ------------------------------------------------------------------
+
+#include <memory>
+#include <vector>
+
+// -- Class --------------------------------------------------------------------
+
+/**
+ * @brief This class hands out memory from large blocks.
+ *
+ * The arena does not support freeing single allocations. Instead the
+ * destructor releases all allocations at once. The converter uses an arena to
+ * store the syntax tree produced by YAEP, since it always drops the whole tree
+ * after walking it.
+ */
+class Arena {
+  /** This variable stores all memory blocks allocated by the arena. */
+  std::vector<std::unique_ptr<char[]>> blocks;
+
+  /** This variable stores the size of the last memory block. */
+  size_t blockSize = 0;
+
+  /** This variable stores the number of used bytes in the last block. */
+  size_t used = 0;
+
+  /**
+   * @brief This method adds a new memory block to the arena.
+   *
+   * @param size This argument specifies the minimum size of the new block.
+   */
+  void grow(size_t const size);
+
+public:
+  /**
+   * @brief This method returns memory for an object of the given size.
+   *
+   * The returned memory is suitably aligned for every fundamental type.
+   *
+   * @param size This number specifies the requested number of bytes.
+   *
+   * @return A pointer to uninitialized memory, which stays valid until the
+   *         destruction of the arena
+   */
+  void *allocate(size_t const size);
+
+  /**
+   * @brief This method releases all memory returned by the arena.
+   *
+   * The arena keeps its largest block, so that it does not have to allocate
+   * memory again for input of a similar size.
+   */
+  void reset();
+};
+
+#endif // ELEKTRA_PLUGIN_YAWN_ARENA_HPP
@@ -0,0 +1,36 @@
+/**
+ * @file
+ *
+ * @brief This file contains a class that stores the location of a top level
+ *        entry of a YAML mapping.
+ *
+ * @copyright BSD License (see LICENSE.md or https://www.libelektra.org)
+ */
+
+#ifndef ELEKTRA_PLUGIN_YAWN_BLOCK_HPP
+#define ELEKTRA_PLUGIN_YAWN_BLOCK_HPP
+
+// -- Imports ------------------------------------------------------------------
+
+#include <string>
+
+// -- Class --------------------------------------------------------------------
+
+/**
+ * @brief This class represents a top level key-value pair of a YAML mapping.
+ *
+ * The range of a block starts at the first byte of the key and ends at the
+ * first byte of the next top level key (or the end of the file). This way the
+ * ranges of all blocks cover the whole mapping.
+ */
+class Block {
+public:
+  /** This variable stores the offset of the first byte of the block. */
+  size_t begin;
+  /** This variable stores the offset after the last byte of the block. */
+  size_t end;
+  /** This attribute stores the (unescaped) base name of the block key. */
+  std::string name;
+};
+
+#endif // ELEKTRA_PLUGIN_YAWN_BLOCK_HPP
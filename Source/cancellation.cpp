@@ -0,0 +1,54 @@
+/**
+ * @file
+ *
+ * @brief This file contains the implementation of a class that allows a
+ *        caller to stop a running conversion.
+ *
+ * @copyright BSD License (see LICENSE.md or https://www.libelektra.org)
+ */
+
+// -- Imports ------------------------------------------------------------------
+
+#include "cancellation.hpp"
+
+using std::memory_order_relaxed;
+using std::runtime_error;
+
+// -- Classes ------------------------------------------------------------------
+
+/**
+ * @brief This constructor creates a token that expires after the given time.
+ *
+ * @param timeout This argument specifies how long a conversion may take
+ *                starting from now.
+ */
+Cancellation::Cancellation(Clock::duration const timeout) {
+  setDeadline(Clock::now() + timeout);
+}
+
+/** @brief This method stops all conversions that use this token. */
+void Cancellation::cancel() { cancelled.store(true, memory_order_relaxed); }
+
+/**
+ * @brief This method sets the time after which the conversion stops.
+ *
+ * @param time This argument specifies the new deadline.
+ */
+void Cancellation::setDeadline(Clock::time_point const time) {
+  deadline.store(time.time_since_epoch().count(), memory_order_relaxed);
+}
+
+/**
+ * @brief This method checks if the converter should stop.
+ *
+ * @retval true If someone called `cancel`, or the deadline passed
+ * @retval false Otherwise
+ */
+bool Cancellation::isCancelled() const {
+  return cancelled.load(memory_order_relaxed) ||
+         Clock::now().time_since_epoch().count() >=
+             deadline.load(memory_order_relaxed);
+}
+
+/** @brief This constructor creates a new cancellation exception. */
+Cancelled::Cancelled() : runtime_error{"Conversion cancelled"} {}
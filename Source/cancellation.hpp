@@ -0,0 +1,86 @@
+/**
+ * @file
+ *
+ * @brief This file contains the declaration of a class that allows a caller
+ *        to stop a running conversion.
+ *
+ * @copyright BSD License (see LICENSE.md or https://www.libelektra.org)
+ */
+
+#ifndef ELEKTRA_PLUGIN_YAWN_CANCELLATION_HPP
+#define ELEKTRA_PLUGIN_YAWN_CANCELLATION_HPP
+
+// -- Imports ------------------------------------------------------------------
+
+#include <atomic>
+#include <chrono>
+#include <stdexcept>
+
+// -- Classes ------------------------------------------------------------------
+
+/**
+ * @brief This class stores if the caller of the converter wants to stop a
+ *        conversion.
+ *
+ * The converter checks the state of this class periodically while it lexes
+ * the input and walks the syntax tree. Another thread can call `cancel` at
+ * any time, while the conversion runs.
+ */
+class Cancellation {
+public:
+  /** This type represents the clock the class uses for deadlines. */
+  using Clock = std::chrono::steady_clock;
+
+private:
+  /** This variable specifies if someone called `cancel`. */
+  std::atomic<bool> cancelled{false};
+
+  /**
+   * This variable stores the time (in ticks of `Clock` since its epoch) after
+   * which the converter stops.
+   */
+  std::atomic<Clock::rep> deadline{Clock::duration::max().count()};
+
+public:
+  /** @brief This constructor creates a token without a deadline. */
+  Cancellation() = default;
+
+  /**
+   * @brief This constructor creates a token that expires after the given
+   *        time.
+   *
+   * @param timeout This argument specifies how long a conversion may take
+   *                starting from now.
+   */
+  explicit Cancellation(Clock::duration const timeout);
+
+  /** @brief This method stops all conversions that use this token. */
+  void cancel();
+
+  /**
+   * @brief This method sets the time after which the conversion stops.
+   *
+   * @param time This argument specifies the new deadline.
+   */
+  void setDeadline(Clock::time_point const time);
+
+  /**
+   * @brief This method checks if the converter should stop.
+   *
+   * @retval true If someone called `cancel`, or the deadline passed
+   * @retval false Otherwise
+   */
+  bool isCancelled() const;
+};
+
+/**
+ * @brief This exception signals that the converter stopped, since the caller
+ *        cancelled the conversion.
+ */
+class Cancelled : public std::runtime_error {
+public:
+  /** @brief This constructor creates a new cancellation exception. */
+  Cancelled();
+};
+
+#endif // ELEKTRA_PLUGIN_YAWN_CANCELLATION_HPP
@@ -8,25 +8,64 @@
 
 // -- Imports ------------------------------------------------------------------
 
-#include <cstdio>
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstring>
+#include <exception>
+#include <functional>
 #include <fstream>
 #include <iostream>
+#include <memory>
+#include <mutex>
 #include <sstream>
+#include <stdexcept>
+#include <thread>
+
+#include <sys/stat.h>
 
 #include <yaep.h>
 
+#include "arena.hpp"
 #include "convert.hpp"
 #include "error_listener.hpp"
+#include "hash.hpp"
 #include "lexer.hpp"
 #include "listener.hpp"
+#include "ring_buffer.hpp"
+#include "trie.hpp"
 #include "walk.hpp"
 
+using std::atomic;
 using std::cerr;
 using std::cout;
+using std::cref;
+using std::current_exception;
 using std::endl;
+using std::exception_ptr;
+using std::function;
+using std::getline;
 using std::ifstream;
+using std::lock_guard;
+using std::length_error;
+using std::make_shared;
+using std::max;
+using std::min;
+using std::move;
+using std::mutex;
+using std::ref;
+using std::rethrow_exception;
+using std::shared_ptr;
+using std::streamsize;
 using std::string;
 using std::stringstream;
+using std::thread;
+using std::time;
+using std::to_string;
+using std::unique_ptr;
+using std::vector;
+
+using Duration = Statistics::Duration;
 
 using CppKey = kdb::Key;
 using CppKeySet = kdb::KeySet;
@@ -34,10 +73,45 @@ using ckdb::keyNew;
 
 namespace {
 
+/** This type represents the queue between a pipelined lexer and the parser. */
+using TokenQueue = RingBuffer<Token, 1024>;
+
+/** This enumeration specifies the next token the parser reads of a document. */
+enum class DocumentPart { streamStart, documentStart, content, streamEnd, end };
+
 // -- Globals ------------------------------------------------------------------
 
+Arena *arenaAddress;
 ErrorListener *errorListenerAdress;
 Lexer *lexerAddress;
+Statistics *statisticsAddress;
+
+/**
+ * YAEP stores the state of the parser in global variables. We therefore only
+ * allow one thread at a time to use the parser.
+ */
+mutex parserMutex;
+
+/** This constant specifies how many bytes we read from a file at once. */
+size_t const readSize = 64 * 1024;
+
+/** This variable stores the index of the next scanned token. */
+size_t scannedTokenIndex;
+
+/**
+ * The parser reads tokens on the thread that started the parse. We therefore
+ * store the queue of the pipelined lexer for each thread.
+ */
+thread_local TokenQueue *tokenQueueAddress;
+
+/** This variable stores the last token the parser read from the queue. */
+thread_local Token lastQueuedToken;
+
+/** This variable stores the token that started the current document. */
+thread_local Token documentStart;
+
+/** This variable stores the token the parser reads next of a document. */
+thread_local DocumentPart documentPart;
 
 // -- Functions ----------------------------------------------------------------
 
@@ -52,7 +126,121 @@ Lexer *lexerAddress;
  * @return A number specifying the type of the first token the parser has not
  *         emitted yet
  */
-int nextToken(void **attribute) { return lexerAddress->nextToken(attribute); }
+int nextToken(void **attribute) {
+  if (!statisticsAddress) {
+    return lexerAddress->nextToken(attribute);
+  }
+  Stopwatch stopwatch{statisticsAddress, &Statistics::lexer};
+  int const type = lexerAddress->nextToken(attribute);
+  stopwatch.stop();
+  return type;
+}
+
+/**
+ * @brief This function returns the next token produced by the lexer and
+ *        allows the lexer to drop the input in front of this token.
+ *
+ * The parser of the validator does not build a syntax tree. It therefore
+ * never accesses the text of tokens it read before.
+ *
+ * @param attribute The parser uses this parameter to store auxiliary data for
+ *                  the returned token.
+ *
+ * @return A number specifying the type of the first token the parser has not
+ *         emitted yet
+ */
+int nextStreamedToken(void **attribute) {
+  int const type = nextToken(attribute);
+  lexerAddress->releaseInput();
+  return type;
+}
+
+/**
+ * @brief This function returns the next token of a lexer that already
+ *        scanned the whole input.
+ *
+ * @param attribute The parser uses this parameter to store auxiliary data for
+ *                  the returned token.
+ *
+ * @return A number specifying the type of the first token the parser has not
+ *         read yet
+ */
+int nextScannedToken(void **attribute) {
+  auto const &tokens = lexerAddress->getTokens();
+  if (scannedTokenIndex >= tokens.size()) {
+    return -1;
+  }
+  *attribute = reinterpret_cast<void *>(
+      static_cast<uintptr_t>(scannedTokenIndex));
+  return tokens[scannedTokenIndex++].getType();
+}
+
+/**
+ * @brief This function returns the next token scanned by a lexer running in
+ *        a separate thread.
+ *
+ * @param attribute The parser uses this parameter to store auxiliary data for
+ *                  the returned token.
+ *
+ * @return A number specifying the type of the first token the parser has not
+ *         read yet
+ */
+int nextQueuedToken(void **attribute) {
+  // The producer stops after the end of the input
+  if (lastQueuedToken.getType() != -1) {
+    while (!tokenQueueAddress->pop(lastQueuedToken)) {
+      std::this_thread::yield();
+    }
+  }
+  return lexerAddress->emit(lastQueuedToken, attribute);
+}
+
+/**
+ * @brief This function returns the next token of the current document.
+ *
+ * The function frames every document with the tokens of a stream, so that
+ * the parser handles each document as a separate input.
+ *
+ * @param attribute The parser uses this parameter to store auxiliary data for
+ *                  the returned token.
+ *
+ * @return A number specifying the type of the first token the parser has not
+ *         read yet
+ */
+int nextDocumentToken(void **attribute) {
+  Token token{-1, documentStart.getEnd(), documentStart.getEnd()};
+  switch (documentPart) {
+  case DocumentPart::streamStart:
+    token = Token{Token::STREAM_START, documentStart.getBegin(),
+                  documentStart.getBegin()};
+    documentPart = DocumentPart::documentStart;
+    break;
+  case DocumentPart::documentStart:
+    token = documentStart;
+    documentPart = DocumentPart::content;
+    break;
+  case DocumentPart::content: {
+    Stopwatch stopwatch{statisticsAddress, &Statistics::lexer};
+    token = lexerAddress->scanToken();
+    stopwatch.stop();
+    if (token.getType() == Token::DOCUMENT_END) {
+      documentStart = token;
+      documentPart = DocumentPart::streamEnd;
+    } else if (token.getType() == -1) {
+      documentPart = DocumentPart::end; // The lexer stopped because of an error
+    }
+    break;
+  }
+  case DocumentPart::streamEnd:
+    token = Token{Token::STREAM_END, documentStart.getEnd(),
+                  documentStart.getEnd()};
+    documentPart = DocumentPart::end;
+    break;
+  case DocumentPart::end:
+    break;
+  }
+  return lexerAddress->emit(token, attribute);
+}
 
 /**
  * @brief This function reacts to syntax errors reported by YAEP’s parsing
@@ -78,6 +266,53 @@ void syntaxError(int errorToken, void *errorTokenData, int ignoredToken,
                                           recoveredToken, recoveredTokenData);
 }
 
+/**
+ * @brief This function allocates memory for the syntax tree produced by YAEP.
+ *
+ * @param size This number specifies the requested number of bytes.
+ *
+ * @return A pointer to memory owned by the arena of the current conversion
+ */
+void *parseAlloc(int size) {
+  return arenaAddress->allocate(static_cast<size_t>(size));
+}
+
+/**
+ * @brief This function ignores requests by YAEP to free memory.
+ *
+ * The arena of the conversion releases the whole syntax tree at once.
+ */
+void parseFree(void *) {}
+
+/**
+ * @brief This function reports an error of a conversion.
+ *
+ * @param message This text describes the error.
+ * @param options This argument specifies where the function stores the
+ *                error. If `options.error` is `nullptr`, then the function
+ *                prints the error to the standard error output.
+ */
+void reportError(string const &message, Options const &options) {
+  if (!options.error) {
+    cerr << message << endl;
+  } else if (options.error->empty()) {
+    *options.error = message;
+  }
+}
+
+/**
+ * @brief This function returns the location of the grammar file the converter
+ *        uses for the given options.
+ *
+ * @param options This argument stores the settings of the converter.
+ *
+ * @return The path of a grammar file
+ */
+string grammarFile(Options const &options) {
+  return options.grammarDirectory +
+         (options.skipComments ? "/yaml_no_comments.bnf" : "/yaml.bnf");
+}
+
 /**
  * @brief This function reads the content of a given grammar file.
  *
@@ -96,71 +331,1871 @@ string readGrammar(string const &filename) {
   return stringStream.str();
 }
 
-} // namespace
+/**
+ * @brief This function stores the size and the hash of a converted text in
+ *        `options.digest`, if the caller asked for them.
+ *
+ * @param text This argument stores the converted text.
+ * @param options This argument stores the settings of the conversion.
+ */
+void recordDigest(string const &text, Options const &options) {
+  if (options.digest) {
+    *options.digest = Digest{};
+    options.digest->add(text.data(), text.size());
+  }
+}
 
 /**
- * @brief This function converts the given YAML file to keys and adds the
- *        result to `keySet`.
+ * @brief This function reads the content of a file.
  *
- * @param keySet The function adds the converted keys to this variable.
- * @param parent The function uses this parent key of `keySet` to emit error
- *               information.
- * @param filename This parameter stores the path of the YAML file this
- *                 function converts.
+ * If the file is larger than `options.maxBytes`, then the function stops
+ * after the first byte above the limit. The lexer then reports the size of
+ * the input as error.
  *
- * @retval -2 if the file could not be opened for reading
- * @retval -1 if there was a error converting the YAML file
- * @retval  0 if parsing was successful and the function did not change the
- *            given keyset
- * @retval  1 if parsing was successful and the function did change `keySet`
+ * @param input This argument stores the opened file.
+ * @param options This argument stores the settings of the conversion. The
+ *                function adds the time spent reading to
+ *                `options.statistics` and records the text in
+ *                `options.digest`, if they are not `nullptr`.
+ *
+ * @return The content of the given file
  */
-int addToKeySet(CppKeySet &keySet, CppKey &parent, string const &filename) {
-  auto const grammar = readGrammar("Grammar/yaml.bnf");
+shared_ptr<string const> readText(ifstream &input, Options const &options) {
+  Stopwatch inputTime{options.statistics, &Statistics::input};
+  if (options.maxBytes == 0) {
+    stringstream stringStream;
+    stringStream << input.rdbuf();
+    auto text = make_shared<string const>(stringStream.str());
+    inputTime.stop();
+    recordDigest(*text, options);
+    return text;
+  }
 
-  yaep parser;
-  if (parser.parse_grammar(1, grammar.c_str()) != 0) {
-    cerr << "Unable to parse grammar:" << parser.error_message() << endl;
-    return EXIT_FAILURE;
+  string text;
+  while (text.size() <= options.maxBytes && input.good()) {
+    size_t const size = text.size();
+    text.resize(size + min(readSize, options.maxBytes + 1 - size));
+    input.read(&text[size], static_cast<streamsize>(text.size() - size));
+    text.resize(size + static_cast<size_t>(input.gcount()));
   }
+  inputTime.stop();
+  recordDigest(text, options);
+  return make_shared<string const>(move(text));
+}
 
-  ErrorListener errorListener;
-  errorListenerAdress = &errorListener;
+/**
+ * @brief This function reports that the converter is unable to access the
+ *        given file.
+ *
+ * The function keeps the value of `errno`, so that callers can still report
+ * the error code.
+ *
+ * @param filename This parameter stores the path of the inaccessible file.
+ * @param options This argument specifies where the function reports the
+ *                error.
+ */
+void reportFileError(string const &filename, Options const &options) {
+  int const code = errno;
+  reportError("Unable to open file “" + filename + "”: " + strerror(code),
+              options);
+  errno = code;
+}
 
-  ifstream input{filename};
+/**
+ * @brief This function opens the given YAML file for reading.
+ *
+ * The function does not check the size of the file, since the size of
+ * streams such as pipes is unknown in advance. The lexer checks the size of
+ * the input while it reads the file instead.
+ *
+ * @param input The function opens the file in this stream.
+ * @param filename This parameter stores the path of the YAML file this
+ *                 function opens.
+ * @param options This argument specifies where the function reports errors.
+ *
+ * @retval -2 if the file could not be opened for reading
+ * @retval  0 if the function opened the file successfully
+ */
+int openInput(ifstream &input, string const &filename,
+              Options const &options) {
+  input.open(filename);
   if (!input.good()) {
-    perror(string("Unable to open file “" + filename + "”").c_str());
+    reportFileError(filename, options);
     return -2;
   }
+  return 0;
+}
+
+/**
+ * @brief This function reads the content of the given YAML file.
+ *
+ * @param text The function stores the content of the file in this variable.
+ *             If the file exceeds `options.maxBytes`, then the text stops
+ *             one byte after the limit.
+ * @param filename This parameter stores the path of the YAML file this
+ *                 function reads.
+ * @param options This argument stores the limits of the converter.
+ *
+ * @retval -2 if the file could not be opened for reading
+ * @retval  0 if the function read the file successfully
+ */
+int openInput(shared_ptr<string const> &text, string const &filename,
+              Options const &options) {
+  ifstream input;
+  int const status = openInput(input, filename, options);
+  if (status == 0) {
+    text = readText(input, options);
+  }
+  return status;
+}
+
+/**
+ * @brief This function copies the given keys including their values and
+ *        metadata.
+ *
+ * @param keys This argument stores the keys this function copies.
+ *
+ * @return A key set that contains a copy of every key in `keys`
+ */
+CppKeySet copyKeys(CppKeySet const &keys) {
+  CppKeySet copy;
+  for (auto const &key : keys) {
+    copy.append(key.dup());
+  }
+  return copy;
+}
+
+/**
+ * @brief This function counts the nodes of a syntax tree.
+ *
+ * @param node This argument specifies the root of the syntax tree.
+ *
+ * @return The number of nodes in the tree with the root `node`
+ */
+size_t countNodes(yaep_tree_node const *node) {
+  if (!node) {
+    return 0;
+  }
+  size_t nodes = 1;
+  if (node->type == YAEP_ANODE) {
+    for (auto child = node->val.anode.children; *child; child++) {
+      nodes += countNodes(*child);
+    }
+  } else if (node->type == YAEP_ALT) {
+    nodes += countNodes(node->val.alt.node) + countNodes(node->val.alt.next);
+  }
+  return nodes;
+}
+
+/**
+ * @brief This function removes all translations from a YAEP grammar.
+ *
+ * Without translations YAEP does not build a syntax tree for the parsed
+ * input.
+ *
+ * @param grammar This argument stores the grammar this function modifies.
+ *
+ * @return A copy of `grammar` without translations
+ */
+string stripTranslations(string const &grammar) {
+  string stripped;
+  stripped.reserve(grammar.size());
+  bool translation = false;
+  for (char const character : grammar) {
+    if (character == '#') {
+      translation = true;
+    } else if (character == '|' || character == ';' || character == '\n') {
+      translation = false;
+    }
+    if (!translation) {
+      stripped += character;
+    }
+  }
+  return stripped;
+}
+
+/**
+ * @brief This function loads a grammar into a parser and applies the engine
+ *        settings of the given options.
+ *
+ * @param parser This argument stores the parser this function initializes.
+ * @param grammar This variable stores the grammar the parser should use.
+ * @param options This argument stores the settings for the parser.
+ *
+ * @retval true If the function was able to initialize the parser
+ * @retval false Otherwise
+ */
+bool prepareParser(yaep &parser, string const &grammar,
+                   Options const &options) {
+  lock_guard<mutex> lock{parserMutex};
+  if (parser.parse_grammar(1, grammar.c_str()) != 0) {
+    reportError(string{"Unable to parse grammar:"} + parser.error_message(),
+                options);
+    return false;
+  }
 
-  Lexer lexer{input};
+  parser.set_lookahead_level(options.lookaheadLevel);
+  parser.set_one_parse_flag(options.oneParse);
+  parser.set_cost_flag(options.cost);
+  parser.set_error_recovery_flag(options.errorRecovery);
+  parser.set_recovery_match(options.recoveryMatch);
+  return true;
+}
+
+/**
+ * @brief This function parses the tokens produced by a lexer.
+ *
+ * @param parser This argument stores the parser this function uses.
+ * @param lexer This argument specifies the lexer that tokenizes the YAML data.
+ * @param readToken This function returns the tokens of `lexer` to the
+ *                  parser.
+ * @param errorListener This variable stores the error listener that records
+ *                      all syntax errors.
+ * @param arena The function stores the syntax tree in this arena.
+ * @param statistics If this argument is not `nullptr`, then the function adds
+ *                   the time spent parsing to it.
+ * @param ambiguous The parser sets this variable to a non-zero value, if the
+ *                  input has multiple syntax trees.
+ *
+ * @return The root of the syntax tree produced by the parser
+ */
+yaep_tree_node *parse(yaep &parser, Lexer &lexer,
+                      int (*readToken)(void **attribute),
+                      ErrorListener &errorListener, Arena &arena,
+                      Statistics *statistics, int &ambiguous) {
+  lock_guard<mutex> lock{parserMutex};
+  arenaAddress = &arena;
   lexerAddress = &lexer;
+  statisticsAddress = statistics;
+  errorListenerAdress = &errorListener;
 
-  int ambiguousOutput;
   struct yaep_tree_node *root = nullptr;
 
-  parser.parse(nextToken, syntaxError, nullptr, nullptr, &root,
-               &ambiguousOutput);
+  Stopwatch parserTime{statistics, &Statistics::parser};
+  auto const lexerTime = statistics ? statistics->lexer : Duration{0};
+  scannedTokenIndex = 0;
+  parser.parse(readToken, syntaxError, parseAlloc, parseFree, &root,
+               &ambiguous);
+  if (statistics) {
+    // The parser calls the lexer, so we subtract the time spent lexing
+    statistics->parser +=
+        parserTime.elapsed() - (statistics->lexer - lexerTime);
+  }
+  return root;
+}
+
+/**
+ * @brief This function adds the counters of a finished parse to the given
+ *        statistics.
+ *
+ * @param lexer This argument specifies the lexer that tokenized the input.
+ * @param root This argument stores the root of the syntax tree.
+ * @param statistics If this argument is not `nullptr`, then the function adds
+ *                   the counters to it.
+ */
+void countTokens(Lexer const &lexer, yaep_tree_node const *root,
+                 Statistics *statistics) {
+  if (!statistics) {
+    return;
+  }
+  statistics->peakQueueSize =
+      max(statistics->peakQueueSize, lexer.getPeakQueueSize());
+  for (auto const &token : lexer.getTokens()) {
+    statistics->tokens[token.getType()]++;
+  }
+  statistics->nodes += countNodes(root);
+}
+
+/**
+ * @brief This function walks a syntax tree and forwards its nodes to a sink.
+ *
+ * @param sink The function calls the methods of this sink while it walks the
+ *             tree.
+ * @param lexer This argument specifies the lexer that tokenized the input.
+ * @param root This argument stores the root of the syntax tree.
+ * @param errorListener This variable stores the error listener that recorded
+ *                      the syntax errors of the parser.
+ * @param ambiguous This variable specifies if the parser reported multiple
+ *                  syntax trees for the input.
+ * @param filename This parameter stores the path of the YAML file this
+ *                 function converts.
+ * @param options This argument stores settings that change how the function
+ *                reads the YAML data.
+ * @param statistics If this argument is not `nullptr`, then the function adds
+ *                   timings and counters to it.
+ *
+ * @retval -3 if the caller cancelled the conversion
+ * @retval -1 if there was a error converting the YAML data
+ * @retval  0 if parsing was successful
+ */
+template <typename Sink>
+int walkTree(Sink &sink, Lexer const &lexer, yaep_tree_node const *root,
+             ErrorListener &errorListener, int const ambiguous,
+             string const &filename, Options const &options,
+             Statistics *statistics) {
+  // The lexer stops at the first check after the caller cancelled the
+  // conversion. The parser then reports a premature end of the input.
+  if (options.cancellation && options.cancellation->isCancelled()) {
+    return -3;
+  }
+
+  if (options.checkAmbiguity && ambiguous) {
+    reportError("The content of file “" + filename +
+                    "” showed that the grammar “" + grammarFile(options) +
+                    "” produces ambiguous output! Please fix the grammar to "
+                    "make sure it produces only one unique syntax tree for "
+                    "every kind of YAML input.",
+                options);
+    return -1;
+  }
 
-  if (ambiguousOutput) {
-    cerr << "The content of file “" + filename +
-                "” showed that the grammar:\n" + grammar +
-                "\nproduces ambiguous output! Please fix the grammar to make "
-                "sure it produces only one unique syntax tree for every kind "
-                "of YAML input.";
+  if (!lexer.getError().empty()) {
+    auto const location = lexer.getErrorLocation();
+    reportError("Unable to parse input: " + filename + ":" +
+                    to_string(location.begin.line) + ":" +
+                    to_string(location.begin.column) + ": " +
+                    lexer.getError(),
+                options);
     return -1;
   }
 
   if (errorListener.getNumberOfErrors() > 0) {
-    cerr << "Unable to parse input: " << errorListener.getErrorMessage()
-         << endl;
+    reportError("Unable to parse input: " + errorListener.getErrorMessage(),
+                options);
+    return -1;
+  }
+
+  if (options.printSyntaxTree) {
+    cout << "\n— Syntax Tree —\n\n" << toString(root, lexer) << endl;
+  }
+
+  Stopwatch walkTime{statistics, &Statistics::walk};
+  try {
+    walk(sink, lexer, root, options.cancellation);
+  } catch (Cancelled const &) {
+    return -3;
+  } catch (length_error const &error) {
+    reportError(string{"Unable to convert input: "} + error.what(), options);
     return -1;
   }
+  walkTime.stop();
+  return 0;
+}
 
-  Listener listener{parent};
-  walk(listener, root);
-  keySet.append(listener.getKeySet());
+/**
+ * @brief This function converts a syntax tree to keys and adds the result to
+ *        `keySet`.
+ *
+ * @param keySet The function adds the converted keys to this variable.
+ * @param parent The function uses this parent key of `keySet` to emit error
+ *               information.
+ * @param lexer This argument specifies the lexer that tokenized the input.
+ * @param root This argument stores the root of the syntax tree.
+ * @param errorListener This variable stores the error listener that recorded
+ *                      the syntax errors of the parser.
+ * @param ambiguous This variable specifies if the parser reported multiple
+ *                  syntax trees for the input.
+ * @param filename This parameter stores the path of the YAML file this
+ *                 function converts.
+ * @param options This argument stores settings that change how the function
+ *                reads the YAML data.
+ * @param statistics If this argument is not `nullptr`, then the function adds
+ *                   timings and counters to it.
+ *
+ * @retval -3 if the caller cancelled the conversion
+ * @retval -1 if there was a error converting the YAML data
+ * @retval  0 if parsing was successful
+ */
+int createKeys(CppKeySet &keySet, CppKey &parent, Lexer const &lexer,
+               yaep_tree_node const *root, ErrorListener &errorListener,
+               int const ambiguous, string const &filename,
+               Options const &options, Statistics *statistics) {
+  Listener listener{parent, options.maxKeys};
+  int const status = walkTree(listener, lexer, root, errorListener, ambiguous,
+                              filename, options, statistics);
+  if (status < 0) {
+    return status;
+  }
 
-  yaep::free_tree(root, nullptr, nullptr);
+  Stopwatch appendTime{statistics, &Statistics::append};
+  auto const keys = listener.getKeySet();
+  keySet.append(keys);
+  appendTime.stop();
+  if (statistics) {
+    statistics->keys += keys.size();
+  }
 
   return 0;
 }
+
+/**
+ * @brief This function converts the tokens produced by a lexer to keys and
+ *        adds the result to `keySet`.
+ *
+ * @param keySet The function adds the converted keys to this variable.
+ * @param parent The function uses this parent key of `keySet` to emit error
+ *               information.
+ * @param lexer This argument specifies the lexer that tokenizes the YAML data.
+ * @param readToken This function returns the tokens of `lexer` to the
+ *                  parser.
+ * @param parser This argument stores the prepared parser this function uses.
+ * @param arena The function stores the syntax tree in this arena.
+ * @param filename This parameter stores the path of the YAML file this
+ *                 function converts.
+ * @param options This argument stores settings that change how the function
+ *                reads the YAML data.
+ * @param statistics If this argument is not `nullptr`, then the function adds
+ *                   timings and counters to it.
+ *
+ * @retval -3 if the caller cancelled the conversion
+ * @retval -1 if there was a error converting the YAML data
+ * @retval  0 if parsing was successful
+ */
+int convertTokens(CppKeySet &keySet, CppKey &parent, Lexer &lexer,
+                  int (*readToken)(void **attribute), yaep &parser,
+                  Arena &arena, string const &filename, Options const &options,
+                  Statistics *statistics) {
+  ErrorListener errorListener{lexer};
+  int ambiguous;
+  auto const root = parse(parser, lexer, readToken, errorListener, arena,
+                          statistics, ambiguous);
+  countTokens(lexer, root, statistics);
+  return createKeys(keySet, parent, lexer, root, errorListener, ambiguous,
+                    filename, options, statistics);
+}
+
+/**
+ * @brief This function scans all tokens of a lexer and adds them to a queue.
+ *
+ * The function runs in its own thread, while the parser reads tokens from
+ * the other end of the queue.
+ *
+ * @param lexer This argument specifies the lexer that tokenizes the YAML data.
+ * @param queue The function adds the scanned tokens to this queue.
+ * @param stop If this variable is `true`, then the function stops scanning.
+ * @param lexerTime The function stores the time spent scanning in this
+ *                  variable, if statistics are enabled.
+ * @param error The function stores an exception thrown by the lexer in this
+ *              variable.
+ */
+void produceTokens(Lexer &lexer, TokenQueue &queue, atomic<bool> const &stop,
+                   Statistics *lexerTime, exception_ptr &error) {
+  Token token{-1, 0, 0};
+  Stopwatch stopwatch{lexerTime, &Statistics::lexer};
+  try {
+    do {
+      token = lexer.scanToken();
+      while (!queue.push(token)) {
+        if (stop) {
+          return;
+        }
+        std::this_thread::yield();
+      }
+    } while (token.getType() != -1 && !stop);
+  } catch (...) {
+    error = current_exception();
+    // Let the parser finish, since it waits for the end of the input
+    while (!queue.push(Token{-1, 0, 0}) && !stop) {
+      std::this_thread::yield();
+    }
+  }
+  stopwatch.stop();
+}
+
+/**
+ * @brief This function converts the tokens produced by a lexer to keys,
+ *        while a separate thread runs the lexer.
+ *
+ * @param keySet The function adds the converted keys to this variable.
+ * @param parent The function uses this parent key of `keySet` to emit error
+ *               information.
+ * @param lexer This argument specifies the lexer that tokenizes the YAML data.
+ * @param parser This argument stores the prepared parser this function uses.
+ * @param arena The function stores the syntax tree in this arena.
+ * @param filename This parameter stores the path of the YAML file this
+ *                 function converts.
+ * @param options This argument stores settings that change how the function
+ *                reads the YAML data.
+ *
+ * @retval -3 if the caller cancelled the conversion
+ * @retval -1 if there was a error converting the YAML data
+ * @retval  0 if parsing was successful
+ */
+int convertPipelined(CppKeySet &keySet, CppKey &parent, Lexer &lexer,
+                     yaep &parser, Arena &arena, string const &filename,
+                     Options const &options) {
+  Statistics *statistics = options.statistics;
+  Statistics producerStatistics;
+  TokenQueue queue;
+  atomic<bool> stop{false};
+  exception_ptr error;
+  thread producer{produceTokens,
+                  ref(lexer),
+                  ref(queue),
+                  cref(stop),
+                  statistics ? &producerStatistics : nullptr,
+                  ref(error)};
+
+  ErrorListener errorListener{lexer};
+  int ambiguous;
+  yaep_tree_node *root;
+  tokenQueueAddress = &queue;
+  lastQueuedToken = Token{0, 0, 0};
+  try {
+    root = parse(parser, lexer, nextQueuedToken, errorListener, arena,
+                 statistics, ambiguous);
+  } catch (...) {
+    stop = true;
+    producer.join();
+    throw;
+  }
+  // The parser stops early on errors, if error recovery is disabled
+  stop = true;
+  producer.join();
+  if (error) {
+    rethrow_exception(error);
+  }
+
+  if (statistics) {
+    statistics->lexer += producerStatistics.lexer;
+  }
+  countTokens(lexer, root, statistics);
+  return createKeys(keySet, parent, lexer, root, errorListener, ambiguous,
+                    filename, options, statistics);
+}
+
+/**
+ * @brief This function converts the tokens produced by a lexer to keys with
+ *        a prepared parser and adds the result to `keySet`.
+ *
+ * @param keySet The function adds the converted keys to this variable.
+ * @param parent The function uses this parent key of `keySet` to emit error
+ *               information.
+ * @param lexer This argument specifies the lexer that tokenizes the YAML data.
+ * @param parser This argument stores the prepared parser this function uses.
+ * @param arena The function stores the syntax tree in this arena.
+ * @param filename This parameter stores the path of the YAML file this
+ *                 function converts.
+ * @param options This argument stores settings that change how the function
+ *                reads the YAML data.
+ *
+ * @retval -3 if the caller cancelled the conversion
+ * @retval -1 if there was a error converting the YAML data
+ * @retval  0 if parsing was successful
+ */
+int convert(CppKeySet &keySet, CppKey &parent, Lexer &lexer, yaep &parser,
+            Arena &arena, string const &filename, Options const &options) {
+  if (options.pipeline) {
+    return convertPipelined(keySet, parent, lexer, parser, arena, filename,
+                            options);
+  }
+  return convertTokens(keySet, parent, lexer, nextToken, parser, arena,
+                       filename, options, options.statistics);
+}
+
+/**
+ * @brief This function converts the tokens produced by a lexer to keys and
+ *        adds the result to `keySet`.
+ *
+ * @param keySet The function adds the converted keys to this variable.
+ * @param parent The function uses this parent key of `keySet` to emit error
+ *               information.
+ * @param lexer This argument specifies the lexer that tokenizes the YAML data.
+ * @param filename This parameter stores the path of the YAML file this
+ *                 function converts.
+ * @param options This argument stores settings that change how the function
+ *                reads the YAML data.
+ *
+ * @retval -3 if the caller cancelled the conversion
+ * @retval -1 if there was a error converting the YAML data
+ * @retval  0 if parsing was successful
+ */
+int convert(CppKeySet &keySet, CppKey &parent, Lexer &lexer,
+            string const &filename, Options const &options) {
+  Stopwatch grammarTime{options.statistics, &Statistics::grammar};
+  auto const grammar = readGrammar(grammarFile(options));
+  yaep parser;
+  if (!prepareParser(parser, grammar, options)) {
+    return -1;
+  }
+  grammarTime.stop();
+
+  Arena arena;
+  return convert(keySet, parent, lexer, parser, arena, filename, options);
+}
+
+/**
+ * @brief This function determines the top level blocks of a YAML mapping.
+ *
+ * @param lexer This argument stores the lexer that tokenized the mapping.
+ * @param blocks The function stores the location of all top level blocks in
+ *               this variable.
+ *
+ * @retval true If the root node is a mapping, whose keys all start at the
+ *              beginning of a line, or if the input does not contain any node
+ * @retval false Otherwise
+ */
+bool findBlocks(Lexer const &lexer, vector<Block> &blocks) {
+  blocks.clear();
+  auto const &tokens = lexer.getTokens();
+  size_t depth = 0;
+
+  for (size_t index = 0; index < tokens.size(); index++) {
+    auto const &token = tokens[index];
+    switch (token.getType()) {
+    case Token::MAPPING_START:
+    case Token::SEQUENCE_START:
+      if (depth == 0 && token.getType() == Token::SEQUENCE_START) {
+        return false;
+      }
+      depth++;
+      break;
+    case Token::BLOCK_END:
+      depth--;
+      break;
+    case Token::KEY:
+      if (depth > 1) {
+        break;
+      }
+      if (lexer.getColumn(token) != 1 || index + 1 >= tokens.size()) {
+        return false;
+      }
+      if (!blocks.empty()) {
+        blocks.back().end = token.getBegin();
+      }
+      blocks.push_back(
+          Block{token.getBegin(), token.getBegin(),
+                scalarToText(lexer.getText(tokens[index + 1]))});
+      break;
+    case Token::STREAM_END:
+      if (!blocks.empty()) {
+        blocks.back().end = token.getBegin();
+      }
+      break;
+    case Token::DOCUMENT_START:
+    case Token::DOCUMENT_END:
+      if (token.getEnd() > token.getBegin()) {
+        return false; // The input contains explicit document markers
+      }
+      break;
+    case Token::STREAM_START:
+    case Token::COMMENT:
+    case -1:
+      break;
+    default:
+      if (depth == 0) {
+        return false; // The root node is a scalar
+      }
+    }
+  }
+  return true;
+}
+
+/**
+ * @brief This function converts a YAML file from scratch and replaces all
+ *        keys below `parent` with the result.
+ *
+ * The function leaves `keySet` and `blocks` untouched, if the conversion
+ * fails.
+ *
+ * @param keySet This variable stores the keys of the previous conversion.
+ * @param parent This key specifies the parent key of all converted keys.
+ * @param filename This parameter stores the path of the YAML file this
+ *                 function converts.
+ * @param blocks The function stores the location of all top level blocks in
+ *               this variable.
+ * @param options This argument stores settings that change how the function
+ *                reads the YAML file.
+ *
+ * @return The status returned by `addToKeySet`
+ */
+int replaceKeySet(CppKeySet &keySet, CppKey &parent, string const &filename,
+                  vector<Block> &blocks, Options const &options) {
+  CppKeySet converted;
+  vector<Block> convertedBlocks;
+  int status =
+      addToKeySet(converted, parent, filename, convertedBlocks, options);
+  if (status < 0) {
+    return status;
+  }
+  keySet.cut(parent);
+  keySet.append(converted);
+  blocks = convertedBlocks;
+  return status;
+}
+
+/**
+ * @brief This function returns the offset after the end of a line.
+ *
+ * @param text This argument stores the text containing the line.
+ * @param line This number specifies the offset of the start of the line.
+ * @param limit This number specifies the offset after the last byte of the
+ *              text the function considers.
+ *
+ * @return The offset of the start of the next line, or `limit`, if the line
+ *         is the last one
+ */
+size_t nextLine(string const &text, size_t const line, size_t const limit) {
+  auto const newline = text.find('\n', line);
+  return newline == string::npos || newline >= limit ? limit : newline + 1;
+}
+
+/**
+ * @brief This function checks if a line contains content that the converter
+ *        can not locate by looking at the start of lines.
+ *
+ * @param text This argument stores the text containing the line.
+ * @param content This number specifies the offset of the first non-space
+ *                character of the line.
+ *
+ * @retval true If the line starts with a tab, a directive or a document
+ *              marker
+ * @retval false Otherwise
+ */
+bool isUnsupportedLine(string const &text, size_t const content) {
+  return text[content] == '\t' || text[content] == '%' ||
+         text.compare(content, 3, "---") == 0 ||
+         text.compare(content, 3, "...") == 0;
+}
+
+/**
+ * @brief This function locates the end of a quoted scalar that starts on a
+ *        given line.
+ *
+ * @param text This argument stores the text containing the scalar.
+ * @param opening This number specifies the offset of the opening quote.
+ * @param lineEnd This number specifies the offset of the end of the line
+ *                (excluding the newline character).
+ *
+ * @return The offset of the closing quote, or `lineEnd` if the scalar does
+ *         not end on the same line
+ */
+size_t findClosingQuote(string const &text, size_t const opening,
+                        size_t const lineEnd) {
+  char const quote = text[opening];
+  size_t closing = opening + 1;
+  while (closing < lineEnd) {
+    // Skip escaped characters and escaped single quotes
+    if (quote == '"' && text[closing] == '\\') {
+      closing += 2;
+      continue;
+    }
+    if (text[closing] == quote) {
+      if (quote == '"' || closing + 1 >= lineEnd ||
+          text[closing + 1] != '\'') {
+        return closing;
+      }
+      closing++;
+    }
+    closing++;
+  }
+  return lineEnd;
+}
+
+/**
+ * @brief This function extracts the key of a line containing a key-value
+ *        pair.
+ *
+ * @param text This argument stores the text containing the line.
+ * @param content This number specifies the offset of the first non-space
+ *                character of the line.
+ * @param lineEnd This number specifies the offset of the end of the line
+ *                (excluding the newline character).
+ * @param key The function stores the text of the key in this variable.
+ * @param inlineValue The function sets this variable to `true`, if the
+ *                    value of the pair starts on the same line as the key.
+ *
+ * @retval true If the line starts with a simple key
+ * @retval false If the function is not able to determine the key of the line,
+ *               or the value of the key is a quoted scalar that does not end
+ *               on the same line
+ */
+bool readKey(string const &text, size_t const content, size_t const lineEnd,
+             string &key, bool &inlineValue) {
+  size_t colon;
+  char const quote = text[content];
+  if (quote == '"' || quote == '\'') {
+    auto const closing = findClosingQuote(text, content, lineEnd);
+    colon = text.find_first_not_of(' ', closing + 1);
+    if (closing >= lineEnd || colon >= lineEnd || text[colon] != ':') {
+      return false;
+    }
+  } else {
+    colon = text.find(':', content);
+    while (colon < lineEnd && colon + 1 < lineEnd && text[colon + 1] != ' ') {
+      colon = text.find(':', colon + 1);
+    }
+    if (colon >= lineEnd || colon == content) {
+      return false;
+    }
+  }
+
+  auto const keyEnd = text.find_last_not_of(' ', colon - 1) + 1;
+  key = scalarToText(text.substr(content, keyEnd - content));
+  auto const value = text.find_first_not_of(' ', colon + 1);
+  inlineValue = value < lineEnd && text[value] != '#';
+  return !inlineValue || (text[value] != '"' && text[value] != '\'') ||
+         findClosingQuote(text, value, lineEnd) < lineEnd;
+}
+
+/**
+ * @brief This function locates the block of a (nested) mapping key by looking
+ *        at the indentation of lines.
+ *
+ * The function does not tokenize the text. It only checks the first
+ * characters of each line to determine the start and the end of blocks.
+ *
+ * @param text This argument stores the YAML data.
+ * @param path This variable stores the names of the keys leading to the
+ *             block, starting at the root of the YAML data.
+ * @param begin The function stores the offset of the line containing the
+ *              last key of `path` in this variable.
+ * @param end The function stores the offset after the last line of the block
+ *            in this variable.
+ *
+ * @retval -1 if the function is not able to locate the block by indentation
+ *            alone
+ * @retval  0 if the text does not contain the given key
+ * @retval  1 if the function found the block of the given key
+ */
+int findSubtree(string const &text, vector<string> const &path, size_t &begin,
+                size_t &end) {
+  size_t regionBegin = 0;
+  size_t regionEnd = text.size();
+
+  for (auto const &segment : path) {
+    size_t level = string::npos;
+    bool found = false;
+    bool inlineValue = false;
+    size_t line = regionBegin;
+    for (; line < regionEnd; line = nextLine(text, line, regionEnd)) {
+      auto const next = nextLine(text, line, regionEnd);
+      auto const lineEnd = next - (text[next - 1] == '\n' ? 1 : 0);
+      auto content = text.find_first_not_of(' ', line);
+      content = content < lineEnd ? content : lineEnd;
+      if (content == lineEnd || text[content] == '#') {
+        continue; // Empty line or comment
+      }
+      if (isUnsupportedLine(text, content)) {
+        return -1;
+      }
+
+      size_t const indentation = content - line;
+      if (level == string::npos) {
+        level = indentation;
+      }
+      if (found) {
+        bool const element =
+            text[content] == '-' &&
+            (content + 1 == lineEnd || text[content + 1] == ' ');
+        if (indentation > level || (indentation == level && element)) {
+          continue;
+        }
+        break;
+      }
+      if (indentation > level) {
+        continue;
+      }
+
+      string key;
+      if (indentation < level ||
+          !readKey(text, content, lineEnd, key, inlineValue)) {
+        return -1;
+      }
+      if (key == segment) {
+        found = true;
+        begin = line;
+      }
+    }
+    if (!found) {
+      return 0;
+    }
+    regionBegin = nextLine(text, begin, regionEnd);
+    regionEnd = line;
+    if (inlineValue && &segment != &path.back()) {
+      return 0; // The value of the key is a scalar
+    }
+  }
+  end = regionEnd;
+  return 1;
+}
+
+/** This class stores a part of the input converted by a separate thread. */
+class Chunk {
+public:
+  /** This variable stores the offset of the first byte of the chunk. */
+  size_t begin;
+
+  /** This variable stores the offset after the last byte of the chunk. */
+  size_t end;
+
+  /** This key specifies the parent key of the converted keys. */
+  CppKey parent;
+
+  /** This variable stores the keys converted from this chunk. */
+  CppKeySet keys;
+
+  /** This variable stores the statistics of the conversion of this chunk. */
+  Statistics statistics;
+
+  /** This variable stores the status of the conversion of this chunk. */
+  int status;
+
+  /** This variable stores an exception thrown by the conversion. */
+  exception_ptr error;
+
+  /**
+   * This variable stores the description of the first error of the
+   * conversion. The caller reports only the error of the first failed chunk.
+   */
+  string message;
+};
+
+/**
+ * @brief This function splits a YAML mapping at the start of top level
+ *        blocks into parts of similar size.
+ *
+ * @param text This argument stores the YAML data.
+ * @param count This number specifies the maximum number of parts.
+ * @param boundaries The function stores the start offset of each part,
+ *                   followed by the size of the text, in this variable.
+ *
+ * @retval true If the function was able to split the text
+ * @retval false If the text contains content at the top level that does not
+ *               start a simple key
+ */
+bool splitBlocks(string const &text, size_t const count,
+                 vector<size_t> &boundaries) {
+  size_t const target = text.size() / count + 1;
+  boundaries.assign(1, 0);
+  for (size_t line = 0; line < text.size();
+       line = nextLine(text, line, text.size())) {
+    auto const next = nextLine(text, line, text.size());
+    auto const lineEnd = next - (text[next - 1] == '\n' ? 1 : 0);
+    if (line == lineEnd || text[line] == ' ' || text[line] == '#') {
+      continue; // Empty line, nested content or comment
+    }
+
+    string key;
+    bool inlineValue;
+    if (isUnsupportedLine(text, line) ||
+        !readKey(text, line, lineEnd, key, inlineValue)) {
+      return false;
+    }
+    if (line >= boundaries.back() + target) {
+      boundaries.push_back(line);
+    }
+  }
+  boundaries.push_back(text.size());
+  return true;
+}
+
+/**
+ * @brief This function converts a chunk of the input to keys.
+ *
+ * The function scans all tokens of the chunk before it acquires the parser.
+ * This way other threads can use the parser while this thread runs the
+ * lexer.
+ *
+ * @param chunk This variable stores the location of the chunk. The function
+ *              stores the result of the conversion in this variable.
+ * @param parser This argument stores the prepared parser shared by all
+ *               threads.
+ * @param text This argument stores the YAML data.
+ * @param filename This parameter stores the path of the converted YAML file.
+ * @param options This argument stores settings that change how the function
+ *                reads the YAML data.
+ */
+void convertChunk(Chunk &chunk, yaep &parser,
+                  shared_ptr<string const> const &text, string const &filename,
+                  Options const &options) {
+  try {
+    Options settings = options;
+    settings.error = &chunk.message;
+    Statistics *statistics = options.statistics ? &chunk.statistics : nullptr;
+    Stopwatch lexerTime{statistics, &Statistics::lexer};
+    Lexer lexer{Input{text, chunk.begin, chunk.end}, settings};
+    void *attribute;
+    while (lexer.nextToken(&attribute) != -1) {
+    }
+    lexerTime.stop();
+    if (options.cancellation && options.cancellation->isCancelled()) {
+      chunk.status = -3;
+      return;
+    }
+
+    Arena arena;
+    chunk.status = convertTokens(chunk.keys, chunk.parent, lexer,
+                                 nextScannedToken, parser, arena, filename,
+                                 settings, statistics);
+  } catch (...) {
+    chunk.error = current_exception();
+  }
+}
+
+/**
+ * @brief This function determines the parts of YAML data that a parallel
+ *        conversion converts in separate threads.
+ *
+ * @param text This argument stores the YAML data.
+ * @param boundaries The function stores the start offset of each part,
+ *                   followed by the size of the text, in this variable.
+ * @param options This argument stores settings that change how the function
+ *                reads the YAML data.
+ *
+ * @retval true If multiple threads should convert the parts of the text
+ * @retval false If a single lexer should convert the whole text
+ */
+bool splitInput(string const &text, vector<size_t> &boundaries,
+                Options const &options) {
+  size_t const threads = options.threads > 0
+                             ? options.threads
+                             : max(thread::hardware_concurrency(), 1u);
+  // A single lexer reports input that exceeds the size limit
+  bool const truncated =
+      options.maxBytes > 0 && text.size() > options.maxBytes;
+  return threads > 1 && !truncated && splitBlocks(text, threads, boundaries) &&
+         boundaries.size() > 2;
+}
+
+/**
+ * @brief This function converts the parts of YAML data in separate threads
+ *        and adds the result to `keySet`.
+ *
+ * Since YAEP stores its state in global variables, only one thread at a time
+ * runs the parser.
+ *
+ * @param keySet The function adds the converted keys to this variable.
+ * @param parent The function uses this parent key of `keySet` to emit error
+ *               information.
+ * @param text This argument stores the YAML data.
+ * @param boundaries This argument stores the start offset of each part,
+ *                   followed by the size of the text.
+ * @param parser This argument stores the prepared parser shared by all
+ *               threads.
+ * @param filename This parameter stores the path of the YAML file this
+ *                 function converts.
+ * @param options This argument stores settings that change how the function
+ *                reads the YAML data.
+ *
+ * @retval -3 if the caller cancelled the conversion
+ * @retval -1 if there was a error converting the YAML data
+ * @retval  0 if parsing was successful
+ */
+int convertChunks(CppKeySet &keySet, CppKey &parent,
+                  shared_ptr<string const> const &text,
+                  vector<size_t> const &boundaries, yaep &parser,
+                  string const &filename, Options const &options) {
+  vector<Chunk> chunks(boundaries.size() - 1);
+  for (size_t index = 0; index < chunks.size(); index++) {
+    chunks[index].begin = boundaries[index];
+    chunks[index].end = boundaries[index + 1];
+    chunks[index].parent = CppKey{parent.getName(), KEY_END};
+  }
+
+  vector<thread> workers;
+  for (auto &chunk : chunks) {
+    workers.emplace_back(convertChunk, ref(chunk), ref(parser), cref(text),
+                         cref(filename), cref(options));
+  }
+  for (auto &worker : workers) {
+    worker.join();
+  }
+
+  CppKeySet converted;
+  for (auto &chunk : chunks) {
+    if (options.statistics) {
+      *options.statistics += chunk.statistics;
+    }
+    if (chunk.error) {
+      rethrow_exception(chunk.error);
+    }
+    if (chunk.status < 0) {
+      if (!chunk.message.empty()) {
+        reportError(chunk.message, options);
+      }
+      return chunk.status;
+    }
+    converted.append(chunk.keys);
+  }
+  if (options.maxKeys > 0 &&
+      static_cast<size_t>(converted.size()) > options.maxKeys) {
+    reportError("Unable to convert input: Input exceeds the maximum "
+                "number of " + to_string(options.maxKeys) + " keys",
+                options);
+    return -1;
+  }
+  keySet.append(converted);
+  return 0;
+}
+
+/**
+ * @brief This function converts YAML data to keys using multiple threads and
+ *        adds the result to `keySet`.
+ *
+ * The function splits the input at the start of top level blocks. Each thread
+ * then lexes, parses and converts a part of the input on its own. Since YAEP
+ * stores its state in global variables, only one thread at a time runs the
+ * parser. If the function is not able to split the input, then it converts
+ * the input sequentially.
+ *
+ * @param keySet The function adds the converted keys to this variable.
+ * @param parent The function uses this parent key of `keySet` to emit error
+ *               information.
+ * @param text This argument stores the YAML data.
+ * @param filename This parameter stores the path of the YAML file this
+ *                 function converts.
+ * @param options This argument stores settings that change how the function
+ *                reads the YAML data.
+ *
+ * @retval -3 if the caller cancelled the conversion
+ * @retval -1 if there was a error converting the YAML data
+ * @retval  0 if parsing was successful
+ */
+int convertParallel(CppKeySet &keySet, CppKey &parent,
+                    shared_ptr<string const> const &text,
+                    string const &filename, Options const &options) {
+  vector<size_t> boundaries;
+  if (!splitInput(*text, boundaries, options)) {
+    Stopwatch lexerTime{options.statistics, &Statistics::lexer};
+    Lexer lexer{Input{text, 0, text->size()}, options};
+    lexerTime.stop();
+    return convert(keySet, parent, lexer, filename, options);
+  }
+
+  Stopwatch grammarTime{options.statistics, &Statistics::grammar};
+  auto const grammar = readGrammar(grammarFile(options));
+  yaep parser;
+  if (!prepareParser(parser, grammar, options)) {
+    return -1;
+  }
+  grammarTime.stop();
+
+  return convertChunks(keySet, parent, text, boundaries, parser, filename,
+                       options);
+}
+
+/**
+ * @brief This function converts YAML data to keys using multiple threads and
+ *        a prepared parser and adds the result to `keySet`.
+ *
+ * All threads share the given parser. If the function is not able to split
+ * the input, then it converts the input sequentially with the given parser
+ * and arena.
+ *
+ * @param keySet The function adds the converted keys to this variable.
+ * @param parent The function uses this parent key of `keySet` to emit error
+ *               information.
+ * @param text This argument stores the YAML data.
+ * @param parser This argument stores the prepared parser this function uses.
+ * @param arena The function stores the syntax tree of a sequential
+ *              conversion in this arena.
+ * @param filename This parameter stores the path of the YAML file this
+ *                 function converts.
+ * @param options This argument stores settings that change how the function
+ *                reads the YAML data.
+ *
+ * @retval -3 if the caller cancelled the conversion
+ * @retval -1 if there was a error converting the YAML data
+ * @retval  0 if parsing was successful
+ */
+int convertParallel(CppKeySet &keySet, CppKey &parent,
+                    shared_ptr<string const> const &text, yaep &parser,
+                    Arena &arena, string const &filename,
+                    Options const &options) {
+  vector<size_t> boundaries;
+  if (!splitInput(*text, boundaries, options)) {
+    Stopwatch lexerTime{options.statistics, &Statistics::lexer};
+    Lexer lexer{Input{text, 0, text->size()}, options};
+    lexerTime.stop();
+    arena.reset();
+    return convert(keySet, parent, lexer, parser, arena, filename, options);
+  }
+  return convertChunks(keySet, parent, text, boundaries, parser, filename,
+                       options);
+}
+
+} // namespace
+
+// -- Class --------------------------------------------------------------------
+
+/**
+ * @brief This constructor creates a converter for the given settings.
+ *
+ * The converter stores errors in its own string instead of the string
+ * `settings.error` points to. Use `getError` to retrieve them.
+ *
+ * @param settings This argument stores settings that change how the converter
+ *                 reads YAML files.
+ */
+Converter::Converter(Options const &settings) : options{settings} {
+  options.error = &error;
+}
+
+/** @brief This destructor releases the parser of the converter. */
+Converter::~Converter() {}
+
+/**
+ * @brief This method prepares the parser of the converter, if it did not do
+ *        so before.
+ *
+ * @retval true If the parser is ready
+ * @retval false If the method was unable to prepare the parser
+ */
+bool Converter::prepare() {
+  if (parser) {
+    return true;
+  }
+  Stopwatch grammarTime{options.statistics, &Statistics::grammar};
+  auto const grammar = readGrammar(grammarFile(options));
+  unique_ptr<yaep> prepared{new yaep};
+  if (!prepareParser(*prepared, grammar, options)) {
+    return false;
+  }
+  parser = move(prepared);
+  grammarTime.stop();
+  return true;
+}
+
+/**
+ * @brief This method converts YAML data stored in memory to keys and adds the
+ *        result to `keySet`.
+ *
+ * @param keySet The method adds the converted keys to this variable.
+ * @param parent The method uses this parent key of `keySet` to emit error
+ *               information.
+ * @param text This parameter stores the YAML data this method converts.
+ * @param filename This parameter stores the path of the YAML file that
+ *                 contained `text`.
+ *
+ * @retval -3 if the caller cancelled the conversion
+ * @retval -1 if there was a error converting the YAML data
+ * @retval  0 if parsing was successful
+ */
+int Converter::convertText(CppKeySet &keySet, CppKey &parent,
+                           shared_ptr<string const> const &text,
+                           string const &filename) {
+  if (!prepare()) {
+    return -1;
+  }
+  // All threads of a parallel conversion share the parser of the converter
+  return convertParallel(keySet, parent, text, *parser, arena, filename,
+                         options);
+}
+
+/**
+ * @brief This method converts the given YAML file to keys, stores the result
+ *        in the cache and adds it to `keySet`.
+ *
+ * The method returns a copy of the keys of the previous conversion, if neither
+ * the location, the modification time, the status change time nor the size of
+ * the file changed. If the time stamp of the file is too close to the last
+ * check to detect all changes, then the method also compares the hash of the
+ * file content.
+ *
+ * @param keySet The method adds the converted keys to this variable.
+ * @param parent The method uses this parent key of `keySet` to emit error
+ *               information.
+ * @param filename This parameter stores the path of the YAML file this
+ *                 method converts.
+ *
+ * @retval -3 if the caller cancelled the conversion
+ * @retval -2 if the file could not be opened for reading
+ * @retval -1 if there was a error converting the YAML file
+ * @retval  0 if the conversion, or the lookup in the cache, was successful
+ */
+int Converter::convertCached(CppKeySet &keySet, CppKey &parent,
+                             string const &filename) {
+  // We check the state of the file before we read it. This way a change
+  // after the check always invalidates the cache entry.
+  struct stat status;
+  if (stat(filename.c_str(), &status) != 0) {
+    cache.erase(filename);
+    reportFileError(filename, options);
+    return -2;
+  }
+  time_t const checked = time(nullptr);
+  auto entry = cache.find(filename);
+  bool const unchanged = entry != cache.end() &&
+                         entry->second.parent == parent.getName() &&
+                         entry->second.device == status.st_dev &&
+                         entry->second.inode == status.st_ino &&
+                         entry->second.modified == status.st_mtime &&
+                         entry->second.changed == status.st_ctime &&
+                         entry->second.size == status.st_size;
+  // A change in the same second as the last check might not update the
+  // modification time of the file
+  if (unchanged && entry->second.modified < entry->second.checked) {
+    keySet.append(copyKeys(entry->second.keys));
+    return 0;
+  }
+
+  shared_ptr<string const> text;
+  int const opened = openInput(text, filename, options);
+  if (opened < 0) {
+    return opened;
+  }
+  uint64_t const hash = hashText(*text);
+  if (unchanged && entry->second.hash == hash) {
+    entry->second.checked = checked;
+    keySet.append(copyKeys(entry->second.keys));
+    return 0;
+  }
+
+  CppKeySet keys;
+  int const result = convertText(keys, parent, text, filename);
+  if (result < 0) {
+    cache.erase(filename);
+    return result;
+  }
+  cache[filename] = CacheEntry{parent.getName(), status.st_dev, status.st_ino,
+                               status.st_mtime, status.st_ctime,
+                               status.st_size, hash, checked, copyKeys(keys)};
+  keySet.append(keys);
+  return result;
+}
+
+/**
+ * @brief This method converts the given YAML file to keys and adds the
+ *        result to `keySet`.
+ *
+ * If `options.cache` is enabled, then the method only converts files that
+ * changed since their last conversion.
+ *
+ * @param keySet The method adds the converted keys to this variable.
+ * @param parent The method uses this parent key of `keySet` to emit error
+ *               information.
+ * @param filename This parameter stores the path of the YAML file this
+ *                 method converts.
+ *
+ * @retval -3 if the caller cancelled the conversion
+ * @retval -2 if the file could not be opened for reading
+ * @retval -1 if there was a error converting the YAML file
+ * @retval  0 if parsing was successful and the method did not change the
+ *            given keyset
+ * @retval  1 if parsing was successful and the method did change `keySet`
+ */
+int Converter::addToKeySet(CppKeySet &keySet, CppKey &parent,
+                           string const &filename) {
+  error.clear();
+  if (options.cache) {
+    return convertCached(keySet, parent, filename);
+  }
+
+  ifstream input;
+  int const opened = openInput(input, filename, options);
+  if (opened < 0) {
+    return opened;
+  }
+  if (options.threads != 1) {
+    return convertText(keySet, parent, readText(input, options), filename);
+  }
+  if (!prepare()) {
+    return -1;
+  }
+
+  Stopwatch lexerTime{options.statistics, &Statistics::lexer};
+  Lexer lexer{input, options};
+  lexerTime.stop();
+  arena.reset();
+  return convert(keySet, parent, lexer, *parser, arena, filename, options);
+}
+
+/**
+ * @brief This method returns the description of the first error of the last
+ *        conversion.
+ *
+ * @return A description of the error, or an empty string if the last
+ *         conversion was successful
+ */
+string const &Converter::getError() const { return error; }
+
+// -- Functions ----------------------------------------------------------------
+
+/**
+ * @brief This function converts the given YAML file to keys and adds the
+ *        result to `keySet`.
+ *
+ * If the file contains multiple documents, then the function merges the keys
+ * of all documents. Keys of later documents replace keys of earlier
+ * documents with the same name.
+ *
+ * @param keySet The function adds the converted keys to this variable.
+ * @param parent The function uses this parent key of `keySet` to emit error
+ *               information.
+ * @param filename This parameter stores the path of the YAML file this
+ *                 function converts.
+ * @param options This argument stores settings that change how the function
+ *                reads the YAML file.
+ *
+ * @retval -3 if the caller cancelled the conversion
+ * @retval -2 if the file could not be opened for reading
+ * @retval -1 if there was a error converting the YAML file
+ * @retval  0 if parsing was successful and the function did not change the
+ *            given keyset
+ * @retval  1 if parsing was successful and the function did change `keySet`
+ */
+int addToKeySet(CppKeySet &keySet, CppKey &parent, string const &filename,
+                Options const &options) {
+  ifstream input;
+  int const opened = openInput(input, filename, options);
+  if (opened < 0) {
+    return opened;
+  }
+
+  if (options.threads != 1) {
+    auto const text = readText(input, options);
+    return convertParallel(keySet, parent, text, filename, options);
+  }
+
+  // The lexer reads the file incrementally, so the lexer stage includes the
+  // time spent reading the input
+  Stopwatch lexerTime{options.statistics, &Statistics::lexer};
+  Lexer lexer{input, options};
+  lexerTime.stop();
+  return convert(keySet, parent, lexer, filename, options);
+}
+
+/**
+ * @brief This function converts YAML data stored in memory to keys and adds
+ *        the result to `keySet`.
+ *
+ * @param keySet The function adds the converted keys to this variable.
+ * @param parent The function uses this parent key of `keySet` to emit error
+ *               information.
+ * @param text This parameter stores the YAML data this function converts.
+ * @param options This argument stores settings that change how the function
+ *                reads the YAML data.
+ *
+ * @retval -3 if the caller cancelled the conversion
+ * @retval -1 if there was a error converting the YAML data
+ * @retval  0 if parsing was successful and the function did not change the
+ *            given keyset
+ * @retval  1 if parsing was successful and the function did change `keySet`
+ */
+int addBufferToKeySet(CppKeySet &keySet, CppKey &parent, string text,
+                      Options const &options) {
+  recordDigest(text, options);
+  auto const input = make_shared<string const>(move(text));
+  // The function falls back to a single lexer for a single thread
+  return convertParallel(keySet, parent, input, "<buffer>", options);
+}
+
+/**
+ * @brief This function converts the given YAML file to keys, adds the result
+ *        to `keySet` and remembers the location of all top level blocks.
+ *
+ * @param keySet The function adds the converted keys to this variable.
+ * @param parent The function uses this parent key of `keySet` to emit error
+ *               information.
+ * @param filename This parameter stores the path of the YAML file this
+ *                 function converts.
+ * @param blocks The function stores the location of all top level blocks in
+ *               this variable. If the root node of the file is not a
+ *               mapping, then the function clears this list.
+ * @param options This argument stores settings that change how the function
+ *                reads the YAML file.
+ *
+ * @retval -3 if the caller cancelled the conversion
+ * @retval -2 if the file could not be opened for reading
+ * @retval -1 if there was a error converting the YAML file
+ * @retval  0 if parsing was successful and the function did not change the
+ *            given keyset
+ * @retval  1 if parsing was successful and the function did change `keySet`
+ */
+int addToKeySet(CppKeySet &keySet, CppKey &parent, string const &filename,
+                vector<Block> &blocks, Options const &options) {
+  ifstream input;
+  int const opened = openInput(input, filename, options);
+  if (opened < 0) {
+    return opened;
+  }
+
+  Stopwatch lexerTime{options.statistics, &Statistics::lexer};
+  Lexer lexer{input, options};
+  lexerTime.stop();
+  int status = convert(keySet, parent, lexer, filename, options);
+  if (status >= 0 && !findBlocks(lexer, blocks)) {
+    blocks.clear();
+  }
+  return status;
+}
+
+/**
+ * @brief This function converts only the part of the given YAML file below a
+ *        certain key and adds the result to `keySet`.
+ *
+ * The function locates the requested block by scanning the indentation of
+ * lines. It only tokenizes and parses the located block. If the function is
+ * not able to locate the block this way, then it converts the whole file and
+ * only keeps the requested part.
+ *
+ * @param keySet The function adds the converted keys to this variable.
+ * @param parent The function uses this parent key of `keySet` to emit error
+ *               information.
+ * @param filename This parameter stores the path of the YAML file this
+ *                 function converts.
+ * @param path This variable stores the name of the requested key relative
+ *             to `parent` (e.g. `primes` or `section/values`).
+ * @param options This argument stores settings that change how the function
+ *                reads the YAML file.
+ *
+ * @retval -3 if the caller cancelled the conversion
+ * @retval -2 if the file could not be opened for reading
+ * @retval -1 if there was a error converting the YAML file
+ * @retval  0 if parsing was successful and the function did not change the
+ *            given keyset
+ * @retval  1 if parsing was successful and the function did change `keySet`
+ */
+int addToKeySet(CppKeySet &keySet, CppKey &parent, string const &filename,
+                string const &path, Options const &options) {
+  shared_ptr<string const> text;
+  int const opened = openInput(text, filename, options);
+  if (opened < 0) {
+    return opened;
+  }
+
+  vector<string> segments;
+  CppKey subtree{parent.getName(), KEY_END};
+  stringstream pathStream{path};
+  for (string segment; getline(pathStream, segment, '/');) {
+    if (!segment.empty()) {
+      segments.push_back(segment);
+      subtree.addBaseName(segment);
+    }
+  }
+
+  size_t begin = 0;
+  size_t end = text->size();
+  // The lexer reports the error for input that exceeds the size limit
+  bool const truncated =
+      options.maxBytes > 0 && text->size() > options.maxBytes;
+  int const located =
+      truncated ? -1 : findSubtree(*text, segments, begin, end);
+  if (located == 0) {
+    return 0;
+  }
+  if (located < 0) {
+    begin = 0;
+    end = text->size();
+  }
+
+  Stopwatch lexerTime{options.statistics, &Statistics::lexer};
+  Lexer lexer{Input{text, begin, end}, options};
+  lexerTime.stop();
+
+  if (located < 0) {
+    CppKeySet converted;
+    int const status = convert(converted, parent, lexer, filename, options);
+    if (status >= 0) {
+      keySet.append(converted.cut(subtree));
+    }
+    return status;
+  }
+
+  // Keys of the block start below the parent of the last path segment
+  CppKey blockParent{parent.getName(), KEY_END};
+  for (size_t segment = 0; segment + 1 < segments.size(); segment++) {
+    blockParent.addBaseName(segments[segment]);
+  }
+  return convert(keySet, blockParent, lexer, filename, options);
+}
+
+/**
+ * @brief This function updates the keys of a previously converted YAML file
+ *        after a local change to the file.
+ *
+ * The function only converts the top level blocks touched by `edit` again.
+ * It then replaces the keys of these blocks in `keySet`. If the function is
+ * not able to determine the changed blocks (for example, because the root
+ * node of the file is not a mapping), then it converts the whole file.
+ *
+ * @param keySet This variable stores the keys of the previous conversion.
+ *               The function replaces the keys of all changed blocks.
+ * @param parent This key specifies the parent key of all converted keys.
+ * @param filename This parameter stores the path of the changed YAML file.
+ * @param blocks This variable stores the location of the top level blocks of
+ *               the previous conversion. The function updates this list to
+ *               match the changed file.
+ * @param edit This argument specifies the changed range of the file.
+ * @param options This argument stores settings that change how the function
+ *                reads the YAML file.
+ *
+ * @retval -3 if the caller cancelled the conversion
+ * @retval -2 if the file could not be opened for reading
+ * @retval -1 if there was a error converting the YAML file
+ * @retval  0 if parsing was successful and the function did not change the
+ *            given keyset
+ * @retval  1 if parsing was successful and the function did change `keySet`
+ */
+int updateKeySet(CppKeySet &keySet, CppKey &parent, string const &filename,
+                 vector<Block> &blocks, Edit const &edit,
+                 Options const &options) {
+  // Locate all blocks touching the changed range
+  size_t first = 0;
+  while (first < blocks.size() && blocks[first].end < edit.begin) {
+    first++;
+  }
+  size_t last = first;
+  while (last < blocks.size() && blocks[last].begin <= edit.oldEnd) {
+    last++;
+  }
+  if (first >= blocks.size()) {
+    return replaceKeySet(keySet, parent, filename, blocks, options);
+  }
+  if (first == last) {
+    last++; // The edit changed the comments in front of the first block
+  }
+
+  shared_ptr<string const> text;
+  int const opened = openInput(text, filename, options);
+  if (opened < 0) {
+    return opened;
+  }
+
+  if (options.maxBytes > 0 && text->size() > options.maxBytes) {
+    // The full conversion reports the size of the input as error
+    return replaceKeySet(keySet, parent, filename, blocks, options);
+  }
+  size_t const begin = first == 0 ? 0 : blocks[first].begin;
+  size_t const end = blocks[last - 1].end - edit.oldEnd + edit.newEnd;
+  bool const beginsLine = begin == 0 || (*text)[begin - 1] == '\n';
+  bool const endsLine = end == 0 || end == text->size() ||
+                        (end < text->size() && (*text)[end - 1] == '\n');
+  if (!beginsLine || !endsLine) {
+    return replaceKeySet(keySet, parent, filename, blocks, options);
+  }
+
+  Stopwatch lexerTime{options.statistics, &Statistics::lexer};
+  Lexer lexer{Input{text, begin, end}, options};
+  lexerTime.stop();
+  CppKeySet changes;
+  vector<Block> changedBlocks;
+  int const status = convert(changes, parent, lexer, filename, options);
+  if (status == -3) {
+    return status;
+  }
+  if (status < 0 || !findBlocks(lexer, changedBlocks)) {
+    return replaceKeySet(keySet, parent, filename, blocks, options);
+  }
+
+  for (size_t block = first; block < last; block++) {
+    CppKey key{parent.getName(), KEY_END};
+    key.addBaseName(blocks[block].name);
+    keySet.cut(key);
+  }
+  keySet.append(changes);
+
+  for (size_t block = last; block < blocks.size(); block++) {
+    blocks[block].begin = blocks[block].begin - edit.oldEnd + edit.newEnd;
+    blocks[block].end = blocks[block].end - edit.oldEnd + edit.newEnd;
+  }
+  blocks.erase(blocks.begin() + first, blocks.begin() + last);
+  blocks.insert(blocks.begin() + first, changedBlocks.begin(),
+                changedBlocks.end());
+
+  return status;
+}
+
+/**
+ * @brief This function checks if the given file contains valid YAML data.
+ *
+ * The function stops at the first syntax error. It neither builds a syntax
+ * tree nor creates any keys.
+ *
+ * @param filename This parameter stores the path of the YAML file this
+ *                 function checks.
+ * @param location The function stores the location of the first syntax error
+ *                 in this variable.
+ * @param message The function stores a description of the first syntax error
+ *                in this variable.
+ * @param options This argument stores settings that change how the function
+ *                reads the YAML file.
+ *
+ * @retval -3 if the caller cancelled the conversion
+ * @retval -2 if the file could not be opened for reading
+ * @retval -1 if the file contains a syntax error
+ * @retval  0 if the file contains valid YAML data
+ */
+int validate(string const &filename, Location &location, string &message,
+             Options const &options) {
+  ifstream input;
+  int const opened = openInput(input, filename, options);
+  if (opened < 0) {
+    return opened;
+  }
+
+  Stopwatch lexerTime{options.statistics, &Statistics::lexer};
+  Lexer lexer{input, options};
+  lexerTime.stop();
+
+  Stopwatch grammarTime{options.statistics, &Statistics::grammar};
+  auto const grammar = stripTranslations(readGrammar(grammarFile(options)));
+  yaep parser;
+  if (!prepareParser(parser, grammar, options)) {
+    return -1;
+  }
+  parser.set_error_recovery_flag(0);
+  grammarTime.stop();
+
+  Arena arena;
+  ErrorListener errorListener{lexer};
+  int ambiguousOutput;
+  parse(parser, lexer, nextStreamedToken, errorListener, arena,
+        options.statistics, ambiguousOutput);
+
+  if (options.cancellation && options.cancellation->isCancelled()) {
+    message = "Conversion cancelled";
+    return -3;
+  }
+  if (!lexer.getError().empty()) {
+    location = lexer.getErrorLocation();
+    message = lexer.getError();
+    return -1;
+  }
+  if (errorListener.getNumberOfErrors() > 0) {
+    location = errorListener.getErrorLocation();
+    message = errorListener.getErrorMessage();
+    return -1;
+  }
+  return 0;
+}
+
+/**
+ * @brief This function converts each document of the given YAML file to keys
+ *        and hands the keys of a document to `callback`, as soon as the
+ *        function converted the document.
+ *
+ * The function reads the file incrementally. It keeps neither the input nor
+ * the tokens of documents it already converted.
+ *
+ * @param parent The function uses this key as parent of the converted keys
+ *               and to emit error information.
+ * @param filename This parameter stores the path of the YAML file this
+ *                 function converts.
+ * @param callback The function calls this function with the keys of each
+ *                 document in the order of the documents in the file.
+ * @param options This argument stores settings that change how the function
+ *                reads the YAML file.
+ *
+ * @retval -3 if the caller cancelled the conversion
+ * @retval -2 if the file could not be opened for reading
+ * @retval -1 if there was a error converting the YAML file
+ * @retval  0 if parsing was successful
+ */
+int forEachDocument(CppKey &parent, string const &filename,
+                    function<void(CppKeySet &keys)> const &callback,
+                    Options const &options) {
+  ifstream input;
+  int const opened = openInput(input, filename, options);
+  if (opened < 0) {
+    return opened;
+  }
+
+  Stopwatch lexerTime{options.statistics, &Statistics::lexer};
+  Lexer lexer{input, options};
+  lexerTime.stop();
+
+  Stopwatch grammarTime{options.statistics, &Statistics::grammar};
+  auto const grammar = readGrammar(grammarFile(options));
+  yaep parser;
+  if (!prepareParser(parser, grammar, options)) {
+    return -1;
+  }
+  grammarTime.stop();
+
+  // The syntax tree of a document is not needed after its conversion
+  Arena arena;
+  while (true) {
+    Stopwatch scanTime{options.statistics, &Statistics::lexer};
+    Token const token = lexer.scanToken();
+    scanTime.stop();
+    if (token.getType() == Token::STREAM_START) {
+      continue;
+    } else if (token.getType() != Token::DOCUMENT_START) {
+      break;
+    }
+
+    documentStart = token;
+    documentPart = DocumentPart::streamStart;
+    CppKeySet keys;
+    arena.reset();
+    int const status = convertTokens(keys, parent, lexer, nextDocumentToken,
+                                     parser, arena, filename, options,
+                                     options.statistics);
+    if (status < 0) {
+      return status;
+    }
+    callback(keys);
+    lexer.discardEmitted();
+  }
+
+  if (options.cancellation && options.cancellation->isCancelled()) {
+    return -3;
+  }
+  if (!lexer.getError().empty()) {
+    auto const location = lexer.getErrorLocation();
+    reportError("Unable to parse input: " + filename + ":" +
+                    to_string(location.begin.line) + ":" +
+                    to_string(location.begin.column) + ": " +
+                    lexer.getError(),
+                options);
+    return -1;
+  }
+  return 0;
+}
+
+/**
+ * @brief This function converts the given YAML file and stores the result in
+ *        a trie.
+ *
+ * The function builds the trie directly while it walks the syntax tree. It
+ * does not create any Elektra keys. The function always uses a single lexer
+ * and ignores the settings `threads` and `pipeline` of `options`.
+ *
+ * @param trie The function adds the converted keys to this trie. If the
+ *             conversion fails, then the trie may contain some of the keys
+ *             of the file.
+ * @param filename This parameter stores the path of the YAML file this
+ *                 function converts.
+ * @param options This argument stores settings that change how the function
+ *                reads the YAML file.
+ *
+ * @retval -3 if the caller cancelled the conversion
+ * @retval -2 if the file could not be opened for reading
+ * @retval -1 if there was a error converting the YAML file
+ * @retval  0 if parsing was successful
+ */
+int addToTrie(KeyTrie &trie, string const &filename, Options const &options) {
+  ifstream input;
+  int const opened = openInput(input, filename, options);
+  if (opened < 0) {
+    return opened;
+  }
+
+  Stopwatch lexerTime{options.statistics, &Statistics::lexer};
+  Lexer lexer{input, options};
+  lexerTime.stop();
+
+  Stopwatch grammarTime{options.statistics, &Statistics::grammar};
+  auto const grammar = readGrammar(grammarFile(options));
+  yaep parser;
+  if (!prepareParser(parser, grammar, options)) {
+    return -1;
+  }
+  grammarTime.stop();
+
+  Arena arena;
+  ErrorListener errorListener{lexer};
+  int ambiguous;
+  auto const root = parse(parser, lexer, nextToken, errorListener, arena,
+                          options.statistics, ambiguous);
+  countTokens(lexer, root, options.statistics);
+  size_t const keys = trie.size();
+  int const status = walkTree(trie, lexer, root, errorListener, ambiguous,
+                              filename, options, options.statistics);
+  if (status == 0 && options.statistics) {
+    options.statistics->keys += trie.size() - keys;
+  }
+  return status;
+}
@@ -12,20 +12,269 @@
 
 // -- Imports ------------------------------------------------------------------
 
+#include <cstdint>
+#include <ctime>
+#include <functional>
+#include <map>
+#include <memory>
+#include <vector>
+
+#include <sys/types.h>
+
 #include <kdb.hpp>
 
-// -- Function -----------------------------------------------------------------
+#include "arena.hpp"
+#include "block.hpp"
+#include "edit.hpp"
+#include "location.hpp"
+#include "options.hpp"
+
+class KeyTrie;
+class yaep;
+
+// -- Class --------------------------------------------------------------------
+
+/**
+ * @brief This class converts YAML files to keys and keeps the state of the
+ *        converter between conversions.
+ *
+ * Reading the grammar and building the parser tables takes longer than
+ * converting a small file. A converter therefore prepares the parser only
+ * once and reuses it, together with the memory of the syntax tree, for all
+ * following conversions. The threads of a parallel conversion share this
+ * parser. Only one thread at a time may use a converter.
+ */
+class Converter {
+  /** This structure stores the result of a previous conversion. */
+  struct CacheEntry {
+    /** This variable stores the name of the parent key of the conversion. */
+    std::string parent;
+
+    /** This variable stores the device that contains the converted file. */
+    dev_t device;
+
+    /** This variable stores the inode number of the converted file. */
+    ino_t inode;
+
+    /** This variable stores the modification time of the converted file. */
+    time_t modified;
+
+    /**
+     * This variable stores the time of the last status change of the
+     * converted file.
+     */
+    time_t changed;
+
+    /** This variable stores the size of the converted file in bytes. */
+    long long size;
+
+    /** This variable stores the hash of the content of the converted file. */
+    uint64_t hash;
+
+    /**
+     * This variable stores the time the converter last checked the state of
+     * the file.
+     */
+    time_t checked;
+
+    /**
+     * This variable stores a copy of the converted keys. Callers only
+     * receive copies of these keys, so that changes to their keys do not
+     * affect the cache.
+     */
+    kdb::KeySet keys;
+  };
+
+  /** This variable stores the settings of all conversions. */
+  Options options;
+
+  /** This variable stores the parser, after the first conversion. */
+  std::unique_ptr<yaep> parser;
+
+  /** This variable stores the syntax tree of the last conversion. */
+  Arena arena;
+
+  /**
+   * This variable maps the path of converted files to the result of their
+   * last conversion, if `options.cache` is enabled.
+   */
+  std::map<std::string, CacheEntry> cache;
+
+  /**
+   * This variable stores the description of the first error of the last
+   * conversion. The variable `options.error` points to this string.
+   */
+  std::string error;
+
+  /**
+   * @brief This method prepares the parser of the converter, if it did not
+   *        do so before.
+   *
+   * @retval true If the parser is ready
+   * @retval false If the method was unable to prepare the parser
+   */
+  bool prepare();
+
+  /**
+   * @brief This method converts YAML data stored in memory to keys and adds
+   *        the result to `keySet`.
+   *
+   * @param keySet The method adds the converted keys to this variable.
+   * @param parent The method uses this parent key of `keySet` to emit error
+   *               information.
+   * @param text This parameter stores the YAML data this method converts.
+   * @param filename This parameter stores the path of the YAML file that
+   *                 contained `text`.
+   *
+   * @retval -3 if the caller cancelled the conversion
+   * @retval -1 if there was a error converting the YAML data
+   * @retval  0 if parsing was successful
+   */
+  int convertText(kdb::KeySet &keySet, kdb::Key &parent,
+                  std::shared_ptr<std::string const> const &text,
+                  std::string const &filename);
+
+  /**
+   * @brief This method converts the given YAML file to keys, stores the
+   *        result in the cache and adds it to `keySet`.
+   *
+   * The method returns a copy of the keys of the previous conversion, if
+   * neither the location, the modification time, the status change time nor
+   * the size of the file changed. If the time stamp of the file is too close
+   * to the last check to detect all changes, then the method also compares
+   * the hash of the file content.
+   *
+   * @param keySet The method adds the converted keys to this variable.
+   * @param parent The method uses this parent key of `keySet` to emit error
+   *               information.
+   * @param filename This parameter stores the path of the YAML file this
+   *                 method converts.
+   *
+   * @retval -3 if the caller cancelled the conversion
+   * @retval -2 if the file could not be opened for reading
+   * @retval -1 if there was a error converting the YAML file
+   * @retval  0 if the conversion, or the lookup in the cache, was successful
+   */
+  int convertCached(kdb::KeySet &keySet, kdb::Key &parent,
+                    std::string const &filename);
+
+public:
+  /**
+   * @brief This constructor creates a converter for the given settings.
+   *
+   * The converter stores errors in its own string instead of the string
+   * `settings.error` points to. Use `getError` to retrieve them.
+   *
+   * @param settings This argument stores settings that change how the
+   *                 converter reads YAML files.
+   */
+  explicit Converter(Options const &settings = Options{});
+
+  // The settings of a converter point to the error string of the converter
+  Converter(Converter const &) = delete;
+  Converter &operator=(Converter const &) = delete;
+
+  /** @brief This destructor releases the parser of the converter. */
+  ~Converter();
+
+  /**
+   * @brief This method converts the given YAML file to keys and adds the
+   *        result to `keySet`.
+   *
+   * If `options.cache` is enabled, then the method only converts files that
+   * changed since their last conversion.
+   *
+   * @param keySet The method adds the converted keys to this variable.
+   * @param parent The method uses this parent key of `keySet` to emit error
+   *               information.
+   * @param filename This parameter stores the path of the YAML file this
+   *                 method converts.
+   *
+   * @retval -3 if the caller cancelled the conversion
+   * @retval -2 if the file could not be opened for reading
+   * @retval -1 if there was a error converting the YAML file
+   * @retval  0 if parsing was successful and the method did not change the
+   *            given keyset
+   * @retval  1 if parsing was successful and the method did change `keySet`
+   */
+  int addToKeySet(kdb::KeySet &keySet, kdb::Key &parent,
+                  std::string const &filename);
+
+  /**
+   * @brief This method returns the description of the first error of the
+   *        last conversion.
+   *
+   * @return A description of the error, or an empty string if the last
+   *         conversion was successful
+   */
+  std::string const &getError() const;
+};
+
+// -- Functions ----------------------------------------------------------------
 
 /**
  * @brief This function converts the given YAML file to keys and adds the
  *        result to `keySet`.
  *
+ * If the file contains multiple documents, then the function merges the keys
+ * of all documents. Keys of later documents replace keys of earlier
+ * documents with the same name.
+ *
+ * @param keySet The function adds the converted keys to this variable.
+ * @param parent The function uses this parent key of `keySet` to emit error
+ *               information.
+ * @param filename This parameter stores the path of the YAML file this
+ *                 function converts.
+ * @param options This argument stores settings that change how the function
+ *                reads the YAML file.
+ *
+ * @retval -3 if the caller cancelled the conversion
+ * @retval -2 if the file could not be opened for reading
+ * @retval -1 if there was a error converting the YAML file
+ * @retval  0 if parsing was successful and the function did not change the
+ *            given keyset
+ * @retval  1 if parsing was successful and the function did change `keySet`
+ */
+int addToKeySet(kdb::KeySet &keySet, kdb::Key &parent,
+                std::string const &filename,
+                Options const &options = Options{});
+
+/**
+ * @brief This function converts YAML data stored in memory to keys and adds
+ *        the result to `keySet`.
+ *
+ * @param keySet The function adds the converted keys to this variable.
+ * @param parent The function uses this parent key of `keySet` to emit error
+ *               information.
+ * @param text This parameter stores the YAML data this function converts.
+ * @param options This argument stores settings that change how the function
+ *                reads the YAML data.
+ *
+ * @retval -3 if the caller cancelled the conversion
+ * @retval -1 if there was a error converting the YAML data
+ * @retval  0 if parsing was successful and the function did not change the
+ *            given keyset
+ * @retval  1 if parsing was successful and the function did change `keySet`
+ */
+int addBufferToKeySet(kdb::KeySet &keySet, kdb::Key &parent,
+                      std::string text, Options const &options = Options{});
+
+/**
+ * @brief This function converts the given YAML file to keys, adds the result
+ *        to `keySet` and remembers the location of all top level blocks.
+ *
  * @param keySet The function adds the converted keys to this variable.
  * @param parent The function uses this parent key of `keySet` to emit error
  *               information.
  * @param filename This parameter stores the path of the YAML file this
  *                 function converts.
+ * @param blocks The function stores the location of all top level blocks in
+ *               this variable. If the root node of the file is not a
+ *               mapping, then the function clears this list.
+ * @param options This argument stores settings that change how the function
+ *                reads the YAML file.
  *
+ * @retval -3 if the caller cancelled the conversion
  * @retval -2 if the file could not be opened for reading
  * @retval -1 if there was a error converting the YAML file
  * @retval  0 if parsing was successful and the function did not change the
@@ -33,6 +282,141 @@
  * @retval  1 if parsing was successful and the function did change `keySet`
  */
 int addToKeySet(kdb::KeySet &keySet, kdb::Key &parent,
-                std::string const &filename);
+                std::string const &filename, std::vector<Block> &blocks,
+                Options const &options = Options{});
+
+/**
+ * @brief This function converts only the part of the given YAML file below a
+ *        certain key and adds the result to `keySet`.
+ *
+ * The function locates the requested block by scanning the indentation of
+ * lines. It only tokenizes and parses the located block. If the function is
+ * not able to locate the block this way, then it converts the whole file and
+ * only keeps the requested part.
+ *
+ * @param keySet The function adds the converted keys to this variable.
+ * @param parent The function uses this parent key of `keySet` to emit error
+ *               information.
+ * @param filename This parameter stores the path of the YAML file this
+ *                 function converts.
+ * @param path This variable stores the name of the requested key relative
+ *             to `parent` (e.g. `primes` or `section/values`).
+ * @param options This argument stores settings that change how the function
+ *                reads the YAML file.
+ *
+ * @retval -3 if the caller cancelled the conversion
+ * @retval -2 if the file could not be opened for reading
+ * @retval -1 if there was a error converting the YAML file
+ * @retval  0 if parsing was successful and the function did not change the
+ *            given keyset
+ * @retval  1 if parsing was successful and the function did change `keySet`
+ */
+int addToKeySet(kdb::KeySet &keySet, kdb::Key &parent,
+                std::string const &filename, std::string const &path,
+                Options const &options = Options{});
+
+/**
+ * @brief This function updates the keys of a previously converted YAML file
+ *        after a local change to the file.
+ *
+ * The function only converts the top level blocks touched by `edit` again.
+ * It then replaces the keys of these blocks in `keySet`. If the function is
+ * not able to determine the changed blocks (for example, because the root
+ * node of the file is not a mapping), then it converts the whole file.
+ *
+ * @param keySet This variable stores the keys of the previous conversion.
+ *               The function replaces the keys of all changed blocks.
+ * @param parent This key specifies the parent key of all converted keys.
+ * @param filename This parameter stores the path of the changed YAML file.
+ * @param blocks This variable stores the location of the top level blocks of
+ *               the previous conversion. The function updates this list to
+ *               match the changed file.
+ * @param edit This argument specifies the changed range of the file.
+ * @param options This argument stores settings that change how the function
+ *                reads the YAML file.
+ *
+ * @retval -3 if the caller cancelled the conversion
+ * @retval -2 if the file could not be opened for reading
+ * @retval -1 if there was a error converting the YAML file
+ * @retval  0 if parsing was successful and the function did not change the
+ *            given keyset
+ * @retval  1 if parsing was successful and the function did change `keySet`
+ */
+int updateKeySet(kdb::KeySet &keySet, kdb::Key &parent,
+                 std::string const &filename, std::vector<Block> &blocks,
+                 Edit const &edit, Options const &options = Options{});
+
+/**
+ * @brief This function checks if the given file contains valid YAML data.
+ *
+ * The function stops at the first syntax error. It neither builds a syntax
+ * tree nor creates any keys.
+ *
+ * @param filename This parameter stores the path of the YAML file this
+ *                 function checks.
+ * @param location The function stores the location of the first syntax error
+ *                 in this variable.
+ * @param message The function stores a description of the first syntax error
+ *                in this variable.
+ * @param options This argument stores settings that change how the function
+ *                reads the YAML file.
+ *
+ * @retval -3 if the caller cancelled the conversion
+ * @retval -2 if the file could not be opened for reading
+ * @retval -1 if the file contains a syntax error
+ * @retval  0 if the file contains valid YAML data
+ */
+int validate(std::string const &filename, Location &location,
+             std::string &message, Options const &options = Options{});
+
+/**
+ * @brief This function converts each document of the given YAML file to keys
+ *        and hands the keys of a document to `callback`, as soon as the
+ *        function converted the document.
+ *
+ * The function reads the file incrementally. It keeps neither the input nor
+ * the tokens of documents it already converted.
+ *
+ * @param parent The function uses this key as parent of the converted keys
+ *               and to emit error information.
+ * @param filename This parameter stores the path of the YAML file this
+ *                 function converts.
+ * @param callback The function calls this function with the keys of each
+ *                 document in the order of the documents in the file.
+ * @param options This argument stores settings that change how the function
+ *                reads the YAML file.
+ *
+ * @retval -3 if the caller cancelled the conversion
+ * @retval -2 if the file could not be opened for reading
+ * @retval -1 if there was a error converting the YAML file
+ * @retval  0 if parsing was successful
+ */
+int forEachDocument(kdb::Key &parent, std::string const &filename,
+                    std::function<void(kdb::KeySet &keys)> const &callback,
+                    Options const &options = Options{});
+
+/**
+ * @brief This function converts the given YAML file and stores the result in
+ *        a trie.
+ *
+ * The function builds the trie directly while it walks the syntax tree. It
+ * does not create any Elektra keys. The function always uses a single lexer
+ * and ignores the settings `threads` and `pipeline` of `options`.
+ *
+ * @param trie The function adds the converted keys to this trie. If the
+ *             conversion fails, then the trie may contain some of the keys
+ *             of the file.
+ * @param filename This parameter stores the path of the YAML file this
+ *                 function converts.
+ * @param options This argument stores settings that change how the function
+ *                reads the YAML file.
+ *
+ * @retval -3 if the caller cancelled the conversion
+ * @retval -2 if the file could not be opened for reading
+ * @retval -1 if there was a error converting the YAML file
+ * @retval  0 if parsing was successful
+ */
+int addToTrie(KeyTrie &trie, std::string const &filename,
+              Options const &options = Options{});
 
 #endif // ELEKTRA_PLUGIN_YAWN_CONVER_HPP
@@ -0,0 +1,34 @@
+/**
+ * @file
+ *
+ * @brief This file contains a class that describes a change to a text.
+ *
+ * @copyright BSD License (see LICENSE.md or https://www.libelektra.org)
+ */
+
+#ifndef ELEKTRA_PLUGIN_YAWN_EDIT_HPP
+#define ELEKTRA_PLUGIN_YAWN_EDIT_HPP
+
+// -- Imports ------------------------------------------------------------------
+
+#include <cstddef>
+
+// -- Class --------------------------------------------------------------------
+
+/**
+ * @brief This class represents the replacement of a byte range in a text.
+ *
+ * The edit replaces the bytes between `begin` and `oldEnd` of the old text
+ * with the bytes between `begin` and `newEnd` of the new text.
+ */
+class Edit {
+public:
+  /** This variable stores the offset of the first changed byte. */
+  size_t begin;
+  /** This variable stores the end of the changed range in the old text. */
+  size_t oldEnd;
+  /** This variable stores the end of the changed range in the new text. */
+  size_t newEnd;
+};
+
+#endif // ELEKTRA_PLUGIN_YAWN_EDIT_HPP
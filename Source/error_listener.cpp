@@ -8,7 +8,6 @@
 
 // -- Imports ------------------------------------------------------------------
 
-#include <memory>
 #include <string>
 
 #include <yaep.h>
@@ -18,10 +17,17 @@
 
 using std::string;
 using std::to_string;
-using std::unique_ptr;
 
 // -- Class --------------------------------------------------------------------
 
+/**
+ * @brief This constructor creates an error listener for the given lexer.
+ *
+ * @param tokenSource This argument specifies the lexer that produces the
+ *                    tokens for the parser.
+ */
+ErrorListener::ErrorListener(Lexer const &tokenSource) : lexer{tokenSource} {}
+
 /**
  * @brief This method reacts to syntax errors reported by YAEP’s parsing
  *        engine.
@@ -45,14 +51,14 @@ void ErrorListener::syntaxError(int errorTokenNumber, void *errorTokenData,
                                 int recoveredToken,
                                 void *recoveredTokenData
                                 __attribute__((unused))) {
-  errors++;
-  message =
-      "Syntax error on token number " + to_string(errorTokenNumber) + ": “" +
-      to_string(**static_cast<unique_ptr<Token> *>(errorTokenData)) + "”\n";
-  if (ignoredToken > 0) {
-    message += "Ignoring " + to_string(recoveredToken - ignoredToken) +
-               " tokens starting with token number " + to_string(ignoredToken);
+  last = lexer.getToken(errorTokenData);
+  if (errors == 0) {
+    first = last;
   }
+  errors++;
+  lastNumber = errorTokenNumber;
+  ignored = ignoredToken;
+  recovered = recoveredToken;
 }
 
 /**
@@ -60,7 +66,27 @@ void ErrorListener::syntaxError(int errorTokenNumber, void *errorTokenData,
  *
  * @return A text describing the last error
  */
-string ErrorListener::getErrorMessage() { return message; }
+string ErrorListener::getErrorMessage() {
+  if (errors == 0) {
+    return "";
+  }
+  string message = "Syntax error on token number " + to_string(lastNumber) +
+                   ": “" + lexer.toString(last) + "”\n";
+  if (ignored > 0) {
+    message += "Ignoring " + to_string(recovered - ignored) +
+               " tokens starting with token number " + to_string(ignored);
+  }
+  return message;
+}
+
+/**
+ * @brief This method returns the location of the first syntax error.
+ *
+ * @return The location of the token where the parser found the first error
+ */
+Location ErrorListener::getErrorLocation() {
+  return errors > 0 ? lexer.getLocation(first) : Location{};
+}
 
 /**
  * @brief This method returns the number of syntax errors reported by YAEP.
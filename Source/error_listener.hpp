@@ -13,18 +13,55 @@
 
 #include <yaep.h>
 
+#include "lexer.hpp"
+
 // -- Class --------------------------------------------------------------------
 
-/** This class reacts to errors reported by the YAML parser. */
+/**
+ * @brief This class reacts to errors reported by the YAML parser.
+ *
+ * The class only records the tokens of an error while the parser runs. It
+ * creates the error message and the error location on request. This way it
+ * does not access the input of the lexer during parsing.
+ */
 class ErrorListener {
 
+  /** This variable stores the lexer that produced the tokens of the parser. */
+  Lexer const &lexer;
+
   /** This attribute stores the number of encountered syntax errors. */
   size_t errors = 0;
 
-  /** This variable stores the last error message produced by the parser. */
-  std::string message;
+  /** This variable stores the token where the first syntax error occurred. */
+  Token first;
+
+  /** This variable stores the token where the last syntax error occurred. */
+  Token last;
+
+  /** This variable stores the number of the token stored in `last`. */
+  int lastNumber = 0;
+
+  /**
+   * This variable stores the number of the first token ignored during the
+   * recovery from the last syntax error.
+   */
+  int ignored = 0;
+
+  /**
+   * This variable stores the number of the first token included after the
+   * recovery from the last syntax error.
+   */
+  int recovered = 0;
 
 public:
+  /**
+   * @brief This constructor creates an error listener for the given lexer.
+   *
+   * @param tokenSource This argument specifies the lexer that produces the
+   *                    tokens for the parser.
+   */
+  ErrorListener(Lexer const &tokenSource);
+
   /**
    * @brief This method reacts to syntax errors reported by YAEP’s parsing
    *        engine.
@@ -53,6 +90,13 @@ public:
    */
   std::string getErrorMessage();
 
+  /**
+   * @brief This method returns the location of the first syntax error.
+   *
+   * @return The location of the token where the parser found the first error
+   */
+  Location getErrorLocation();
+
   /**
    * @brief This method returns the number of syntax errors reported by YAEP.
    *
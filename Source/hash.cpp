@@ -0,0 +1,43 @@
+/**
+ * @file
+ *
+ * @brief This file contains a fast, non-cryptographic hash function.
+ *
+ * @copyright BSD License (see LICENSE.md or https://www.libelektra.org)
+ */
+
+// -- Imports ------------------------------------------------------------------
+
+#include "hash.hpp"
+
+using std::string;
+
+// -- Class --------------------------------------------------------------------
+
+/**
+ * @brief This method adds the next part of the text to the digest.
+ *
+ * @param text This argument points to the first byte of the part.
+ * @param length This number specifies the size of the part in bytes.
+ */
+void Digest::add(char const *text, size_t const length) {
+  for (size_t index = 0; index < length; index++) {
+    hash = (hash ^ static_cast<unsigned char>(text[index])) * 1099511628211ull;
+  }
+  size += length;
+}
+
+// -- Function -----------------------------------------------------------------
+
+/**
+ * @brief This function calculates the 64 bit FNV-1a hash of a text.
+ *
+ * @param text This argument stores the text this function hashes.
+ *
+ * @return The hash of `text`
+ */
+uint64_t hashText(string const &text) {
+  Digest digest;
+  digest.add(text.data(), text.size());
+  return digest.hash;
+}
@@ -0,0 +1,53 @@
+/**
+ * @file
+ *
+ * @brief This file contains the declaration of a fast, non-cryptographic
+ *        hash function.
+ *
+ * @copyright BSD License (see LICENSE.md or https://www.libelektra.org)
+ */
+
+#ifndef ELEKTRA_PLUGIN_YAWN_HASH_HPP
+#define ELEKTRA_PLUGIN_YAWN_HASH_HPP
+
+// -- Imports ------------------------------------------------------------------
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+// -- Class --------------------------------------------------------------------
+
+/**
+ * @brief This class calculates the size and the 64 bit FNV-1a hash of a text
+ *        that arrives in parts.
+ */
+class Digest {
+public:
+  /** This number stores the size of all parts added so far in bytes. */
+  uint64_t size = 0;
+
+  /** This number stores the hash of all parts added so far. */
+  uint64_t hash = 14695981039346656037ull;
+
+  /**
+   * @brief This method adds the next part of the text to the digest.
+   *
+   * @param text This argument points to the first byte of the part.
+   * @param length This number specifies the size of the part in bytes.
+   */
+  void add(char const *text, size_t const length);
+};
+
+// -- Function -----------------------------------------------------------------
+
+/**
+ * @brief This function calculates the 64 bit FNV-1a hash of a text.
+ *
+ * @param text This argument stores the text this function hashes.
+ *
+ * @return The hash of `text`
+ */
+uint64_t hashText(std::string const &text);
+
+#endif // ELEKTRA_PLUGIN_YAWN_HASH_HPP
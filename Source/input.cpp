@@ -9,66 +9,343 @@
 
 // -- Imports ------------------------------------------------------------------
 
-#include <codecvt>
-#include <locale>
-#include <sstream>
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
 #include <stdexcept>
+#include <system_error>
+
+#include <unistd.h>
 
 #include "input.hpp"
 
-using std::codecvt_utf8;
-using std::ifstream;
+using std::count;
+using std::generic_category;
+using std::istream;
+using std::make_shared;
+using std::min;
 using std::out_of_range;
+using std::shared_ptr;
 using std::string;
-using std::stringstream;
-using std::wstring_convert;
+using std::system_error;
+using std::upper_bound;
+
+namespace {
+
+// -- Globals ------------------------------------------------------------------
+
+/** This constant specifies how many bytes an input reads from a stream. */
+size_t const chunkSize = 64 * 1024;
+
+} // namespace
+
+// -- Classes ------------------------------------------------------------------
+
+/** This class stores the retained text of a stream. */
+class Input::Window {
+public:
+  /** This variable stores the stream the window reads from. */
+  istream *stream = nullptr;
+
+  /** This variable stores the file descriptor the window reads from. */
+  int descriptor = -1;
+
+  /** This variable stores the retained text of the stream. */
+  string text;
+
+  /** This variable stores the offset of the first byte of `text`. */
+  size_t begin = 0;
+
+  /** This variable specifies if the window read the whole stream. */
+  bool exhausted = false;
+
+  /**
+   * If this variable is not `nullptr`, then the window adds every byte it
+   * reads to the pointed to digest.
+   */
+  Digest *digest = nullptr;
+
+  /**
+   * @brief This method appends the next chunk of the stream to `text`.
+   *
+   * @param bytes This number specifies the maximum number of bytes this
+   *              method reads.
+   */
+  void read(size_t const bytes) {
+    size_t const size = text.size();
+    text.resize(size + bytes);
+    size_t received = 0;
+    if (stream) {
+      stream->read(&text[size], static_cast<std::streamsize>(bytes));
+      received = static_cast<size_t>(stream->gcount());
+    } else {
+      ssize_t result;
+      do {
+        result = ::read(descriptor, &text[size], bytes);
+      } while (result < 0 && errno == EINTR);
+      if (result < 0) {
+        text.resize(size);
+        throw system_error(errno, generic_category(), "Unable to read input");
+      }
+      received = static_cast<size_t>(result);
+    }
+    text.resize(size + received);
+    if (digest) {
+      digest->add(text.data() + size, received);
+    }
+    exhausted = received == 0;
+  }
+};
+
+// ===========
+// = Private =
+// ===========
+
+/**
+ * @brief This method extends the table of line start offsets until it
+ *        contains every line that starts at or before `offset`.
+ *
+ * @param offset This parameter specifies the offset of a byte in `input`.
+ */
+void Input::indexLines(size_t const offset) const {
+  size_t const start = base();
+  while (indexed < offset) {
+    auto newline = static_cast<char const *>(memchr(
+        buffer->data() + indexed - start, '\n', limit - indexed));
+    if (newline == nullptr) {
+      indexed = limit;
+      return;
+    }
+    indexed = static_cast<size_t>(newline - buffer->data()) + start + 1;
+    lines.push_back(indexed);
+  }
+}
+
+/**
+ * @brief This method returns the offset of the first retained byte.
+ *
+ * @return The offset of the byte stored at the start of `buffer`
+ */
+size_t Input::base() const { return window ? window->begin : 0; }
+
+/**
+ * @brief This method reads from the stream of this input until the retained
+ *        text contains the byte before `end`.
+ *
+ * @param end This parameter specifies the offset after the last byte this
+ *            method should read.
+ *
+ * @retval true If the input contains the byte before `end`
+ * @retval false If the input ends before `end`
+ */
+bool Input::fill(size_t const end) const {
+  if (!window) {
+    return false;
+  }
+  while (window->begin + window->text.size() < end && !window->exhausted &&
+         !exceedsMaxBytes()) {
+    size_t bytes = chunkSize;
+    if (maxBytes > 0) {
+      // One byte more than the limit shows that the input is too large
+      bytes = min(bytes, maxBytes + 1 - window->begin - window->text.size());
+    }
+    window->read(bytes);
+  }
+  limit = window->begin + window->text.size();
+  return end <= limit;
+}
 
-// -- Class --------------------------------------------------------------------
+// ==========
+// = Public =
+// ==========
 
 /**
- * @brief This constructor creates an input from the given stream.
+ * @brief This constructor creates an input that reads the given stream
+ *        incrementally.
+ *
+ * The stream has to stay valid as long as the lexer reads from this input.
  *
  * @param stream This parameter stores the text this object operates on.
  */
-Input::Input(ifstream const &stream) {
-  stringstream stringStream;
-  stringStream << stream.rdbuf();
-  input = wstring_convert<codecvt_utf8<char32_t>, char32_t>{}.from_bytes(
-      stringStream.str());
+Input::Input(istream &stream) : window{make_shared<Window>()} {
+  window->stream = &stream;
+  buffer = &window->text;
+  skippedLinesCounted = true;
+}
+
+/**
+ * @brief This constructor creates an input that reads the given file
+ *        descriptor incrementally.
+ *
+ * The input does not close the file descriptor.
+ *
+ * @param descriptor This parameter specifies an open file descriptor that
+ *                   this object reads the text from.
+ */
+Input::Input(int const descriptor) : window{make_shared<Window>()} {
+  window->descriptor = descriptor;
+  buffer = &window->text;
+  skippedLinesCounted = true;
+}
+
+/**
+ * @brief This constructor creates an input for a part of the given text.
+ *
+ * @param text This parameter stores the text this object operates on.
+ * @param begin This number specifies the offset of the first byte of the
+ *              part. The offset must point to the start of a line.
+ * @param end This number specifies the offset after the last byte of the
+ *            part.
+ */
+Input::Input(shared_ptr<string const> const &text, size_t const begin,
+             size_t const end)
+    : input{text}, buffer{text.get()}, position{begin}, limit{end},
+      lines{begin}, indexed{begin}, skippedLinesCounted{begin == 0} {}
+
+/**
+ * @brief This method sets the maximum size of the input.
+ *
+ * An input created from a stream or file descriptor stops reading as soon as
+ * it read more than `bytes` bytes. The lexer then sees the end of the input.
+ *
+ * @param bytes This number specifies the maximum size of the whole input in
+ *              bytes. The value `0` disables the limit.
+ */
+void Input::setMaxBytes(size_t const bytes) { maxBytes = bytes; }
+
+/**
+ * @brief This method specifies where the input records the size and the hash
+ *        of the text it reads.
+ *
+ * Only an input created from a stream or file descriptor uses the digest. The
+ * caller of an input created from a text already knows the text.
+ *
+ * @param digest The input resets this digest and adds every byte it reads
+ *               from its stream to it. The value `nullptr` disables the
+ *               digest.
+ */
+void Input::setDigest(Digest *digest) {
+  if (!window || !digest) {
+    return;
+  }
+  *digest = Digest{};
+  digest->add(window->text.data(), window->text.size());
+  window->digest = digest;
+}
+
+/**
+ * @brief This method checks if the input is larger than the maximum size.
+ *
+ * @retval true If the whole input is larger than the maximum size set with
+ *              `setMaxBytes`
+ * @retval false Otherwise
+ */
+bool Input::exceedsMaxBytes() const {
+  if (maxBytes == 0) {
+    return false;
+  }
+  return (window ? window->begin + window->text.size() : input->size()) >
+         maxBytes;
 }
 
 /**
- * @brief This function returns a character that was not consumed yet.
+ * @brief This function returns a byte that was not consumed yet.
  *
- * @param offset This variable specifies the index of the character
- *               this method should retrieve as offset to the last consumed
- *               character.
+ * @param offset This variable specifies the index of the byte this method
+ *               should retrieve as offset to the last consumed byte.
  *
- * @return A character which is `offset` positions away from the last
- *         consumed character
+ * @return A byte which is `offset` positions away from the last consumed
+ *         byte
  */
 size_t Input::LA(size_t const offset) const {
-  if (offset == 0 || position + offset > input.size()) {
+  if (offset == 0 || (position + offset > limit && !fill(position + offset))) {
     return 0;
   }
-  return input[position + offset - 1];
+  return static_cast<unsigned char>(
+      (*buffer)[position + offset - 1 - base()]);
 }
 
 /**
- * @brief This method consumes the next character of `input`.
+ * @brief This method consumes the next byte of `input`.
  */
 void Input::consume() {
-  if (position + 1 > input.size()) {
+  if (position + 1 > limit && !fill(position + 1)) {
     throw out_of_range("Unable to consume EOF");
     return;
   }
   position++;
 }
 
+/**
+ * @brief This method consumes the given number of bytes of `input`.
+ *
+ * @param bytes This number specifies how many bytes this method consumes.
+ */
+void Input::consume(size_t const bytes) {
+  if (position + bytes > limit && !fill(position + bytes)) {
+    throw out_of_range("Unable to consume EOF");
+  }
+  position += bytes;
+}
+
+/**
+ * @brief This method returns the number of bytes in front of the next newline
+ *        character.
+ *
+ * The method searches for the newline character in bulk instead of looking at
+ * single bytes.
+ *
+ * @return The number of bytes between the current position and the end of the
+ *         current line (or the end of the input)
+ */
+size_t Input::lineLength() const {
+  size_t searched = position;
+  while (true) {
+    // Reading from a stream might move the retained text
+    auto newline = static_cast<char const *>(memchr(
+        buffer->data() + searched - base(), '\n', limit - searched));
+    if (newline != nullptr) {
+      return static_cast<size_t>(newline - buffer->data()) + base() -
+             position;
+    }
+    searched = limit;
+    if (!fill(limit + 1)) {
+      return limit - position;
+    }
+  }
+}
+
+/**
+ * @brief This method allows the input to drop the text in front of the given
+ *        offset.
+ *
+ * The input keeps the start of the line containing `offset`, so that it is
+ * still able to determine positions in this line. For an input created from a
+ * text this method does nothing.
+ *
+ * @param offset This parameter specifies the offset of the first byte the
+ *               caller still needs.
+ */
+void Input::release(size_t const offset) {
+  if (!window) {
+    return;
+  }
+  // We need to remember the lines of the dropped text to compute positions
+  indexLines(offset);
+  size_t const start =
+      *(upper_bound(lines.begin(), lines.end(), offset) - 1);
+  size_t const dropped = start > window->begin ? start - window->begin : 0;
+  // Moving the retained text only pays off, if we drop a large part
+  if (dropped >= chunkSize && dropped * 2 >= window->text.size()) {
+    window->text.erase(0, dropped);
+    window->begin = start;
+  }
+}
+
 /**
  * @brief Retrieve the current position inside the input.
  *
- * @return The current position in number of characters
+ * @return The current position in number of bytes
  */
 size_t Input::index() const { return position; }
 
@@ -83,7 +360,119 @@ size_t Input::index() const { return position; }
  *         one character before the current position in the input
  */
 string Input::getText(size_t const start) const {
-  string text = wstring_convert<codecvt_utf8<char32_t>, char32_t>{}.to_bytes(
-      input.substr(start, position - start));
-  return text;
+  return getText(start, position);
+}
+
+/**
+ * @brief This method retrieves the text between `start` (inclusive) and
+ *        `end` (exclusive).
+ *
+ * @param start This parameter specifies the start index of the string this
+ *              functions returns.
+ * @param end This parameter specifies the index after the last byte of the
+ *            string this function returns.
+ *
+ * @return A UTF-8 encoded substring of input starting at `start` and ending
+ *         one byte before `end`
+ */
+string Input::getText(size_t const start, size_t const end) const {
+  if (start < base()) {
+    throw out_of_range("Unable to access released input");
+  }
+  return buffer->substr(start - base(), end - start);
+}
+
+/**
+ * @brief This method appends the text between `start` (inclusive) and `end`
+ *        (exclusive) to a string.
+ *
+ * @param text The method appends the text of the input to this string.
+ * @param start This parameter specifies the start index of the text this
+ *              method appends.
+ * @param end This parameter specifies the index after the last byte of the
+ *            text this method appends.
+ */
+void Input::appendText(string &text, size_t const start,
+                       size_t const end) const {
+  if (start < base()) {
+    throw out_of_range("Unable to access released input");
+  }
+  text.append(*buffer, start - base(), end - start);
+}
+
+/**
+ * @brief This method returns the offset of the first occurrence of a byte
+ *        between `start` (inclusive) and `end` (exclusive).
+ *
+ * @param byte This parameter specifies the byte this method searches for.
+ * @param start This parameter specifies the start index of the search.
+ * @param end This parameter specifies the index after the last byte of the
+ *            search.
+ *
+ * @return The offset of the first byte `byte` in the given range, or `end` if
+ *         the range does not contain `byte`
+ */
+size_t Input::find(char const byte, size_t const start,
+                   size_t const end) const {
+  if (start < base()) {
+    throw out_of_range("Unable to access released input");
+  }
+  auto found = static_cast<char const *>(
+      memchr(buffer->data() + start - base(), byte, end - start));
+  if (found == nullptr) {
+    return end;
+  }
+  return static_cast<size_t>(found - buffer->data()) + base();
+}
+
+/**
+ * @brief This method returns the column of the byte at the given offset.
+ *
+ * In contrast to the columns returned by `getPosition`, this method counts
+ * bytes instead of characters. This is enough to compare the indentation of
+ * tokens, since indentation only consists of space characters.
+ *
+ * @param offset This parameter specifies the offset of a byte in the input.
+ *
+ * @return The column number (starting at 1) of the given byte
+ */
+size_t Input::column(size_t const offset) const {
+  indexLines(offset);
+  // The lexer usually asks for bytes in the last line it visited
+  if (offset >= lines.back()) {
+    return offset - lines.back() + 1;
+  }
+  auto line = upper_bound(lines.begin(), lines.end(), offset) - 1;
+  return offset - *line + 1;
+}
+
+/**
+ * @brief This method returns the position of the byte at the given offset.
+ *
+ * @param offset This parameter specifies the offset of a byte in the input.
+ *
+ * @return The line and column number (counted in characters) of the byte
+ */
+Position Input::getPosition(size_t const offset) const {
+  indexLines(offset);
+  if (!skippedLinesCounted) {
+    skippedLines = static_cast<size_t>(
+        count(input->begin(), input->begin() + lines.front(), '\n'));
+    skippedLinesCounted = true;
+  }
+  auto line = upper_bound(lines.begin(), lines.end(), offset) - 1;
+  size_t const start = base();
+  if (*line < start) {
+    throw out_of_range("Unable to access released input");
+  }
+  Position result;
+  result.line = skippedLines + static_cast<size_t>(line - lines.begin()) + 1;
+  // Count every byte except for continuation bytes of multibyte characters
+  for (size_t index = *line; index < offset && index < limit; index++) {
+    auto const byte = static_cast<unsigned char>((*buffer)[index - start]);
+    if ((byte & 0xC0) != 0x80) {
+      result.column++;
+    }
+  }
+  return result;
 }
@@ -12,50 +12,242 @@
 
 // -- Imports ------------------------------------------------------------------
 
-#include <fstream>
+#include <istream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "hash.hpp"
+#include "position.hpp"
 
 // -- Class --------------------------------------------------------------------
 
 /**
  * @brief This class provides methods for a lexer to analyze textual input.
+ *
+ * The class operates on the UTF-8 encoded bytes of the input directly. Since
+ * every character with a special meaning in YAML is part of ASCII, and UTF-8
+ * never uses ASCII bytes inside multibyte sequences, the lexer does not need
+ * to decode the input.
+ *
+ * An input can also represent only a part of a text. In this case the lexer
+ * sees the end of the part as end of the input, while all offsets still refer
+ * to the whole text. Copies of an input share the same text.
+ *
+ * An input created from a stream or file descriptor reads the text in chunks,
+ * when the lexer looks at bytes it did not read yet. Such an input only
+ * retains the text after the offset passed to `release`. All methods that
+ * access the content of the input only work inside this retained window.
  */
 class Input {
 
-  /** This variable stores the input represented by this class. */
-  std::u32string input;
+  /** This class stores the retained text of a stream. */
+  class Window;
+
+  /**
+   * This variable stores the text represented by this class. For an input
+   * created from a stream this variable is empty.
+   */
+  std::shared_ptr<std::string const> input;
+
+  /**
+   * This variable stores the state of the stream this object reads from. For
+   * an input created from a text this variable is empty.
+   */
+  std::shared_ptr<Window> window;
+
+  /**
+   * This variable points to the text of `input` or the retained text of
+   * `window`.
+   */
+  std::string const *buffer;
 
   /** This variable stores the current position inside `input`. */
   size_t position = 0;
 
+  /**
+   * This variable stores the offset after the last byte of `input` this object
+   * provides to the lexer. For a stream this is the offset after the last
+   * byte read so far.
+   */
+  mutable size_t limit = 0;
+
+  /**
+   * This vector stores the offset of the first byte of every line in `input`
+   * up to the offset `indexed`. We only build this table when someone asks
+   * for the position of a certain byte.
+   */
+  mutable std::vector<size_t> lines{0};
+
+  /** This variable stores the number of bytes already searched for lines. */
+  mutable size_t indexed = 0;
+
+  /**
+   * This variable stores the maximum size of the whole input in bytes. The
+   * value `0` disables the limit.
+   */
+  size_t maxBytes = 0;
+
+  /**
+   * This variable stores the number of lines in front of the first offset
+   * this object provides. We only count these lines, if someone asks for the
+   * position of a byte.
+   */
+  mutable size_t skippedLines = 0;
+
+  /**
+   * This boolean specifies if `skippedLines` stores the correct number of
+   * lines already.
+   */
+  mutable bool skippedLinesCounted = false;
+
+  /**
+   * @brief This method extends the table of line start offsets until it
+   *        contains every line that starts at or before `offset`.
+   *
+   * @param offset This parameter specifies the offset of a byte in `input`.
+   */
+  void indexLines(size_t const offset) const;
+
+  /**
+   * @brief This method returns the offset of the first retained byte.
+   *
+   * @return The offset of the byte stored at the start of `buffer`
+   */
+  size_t base() const;
+
+  /**
+   * @brief This method reads from the stream of this input until the
+   *        retained text contains the byte before `end`.
+   *
+   * @param end This parameter specifies the offset after the last byte this
+   *            method should read.
+   *
+   * @retval true If the input contains the byte before `end`
+   * @retval false If the input ends before `end`
+   */
+  bool fill(size_t const end) const;
+
 public:
   /**
-   * @brief This constructor creates an input from the given stream.
+   * @brief This constructor creates an input that reads the given stream
+   *        incrementally.
+   *
+   * The stream has to stay valid as long as the lexer reads from this input.
    *
    * @param stream This parameter stores the text this object operates on.
    */
-  Input(std::ifstream const &stream);
+  Input(std::istream &stream);
+
+  /**
+   * @brief This constructor creates an input that reads the given file
+   *        descriptor incrementally.
+   *
+   * The input does not close the file descriptor.
+   *
+   * @param descriptor This parameter specifies an open file descriptor that
+   *                   this object reads the text from.
+   */
+  Input(int const descriptor);
+
+  /**
+   * @brief This constructor creates an input for a part of the given text.
+   *
+   * @param text This parameter stores the text this object operates on.
+   * @param begin This number specifies the offset of the first byte of the
+   *              part. The offset must point to the start of a line.
+   * @param end This number specifies the offset after the last byte of the
+   *            part.
+   */
+  Input(std::shared_ptr<std::string const> const &text, size_t const begin,
+        size_t const end);
+
+  /**
+   * @brief This method sets the maximum size of the input.
+   *
+   * An input created from a stream or file descriptor stops reading as soon
+   * as it read more than `bytes` bytes. The lexer then sees the end of the
+   * input.
+   *
+   * @param bytes This number specifies the maximum size of the whole input
+   *              in bytes. The value `0` disables the limit.
+   */
+  void setMaxBytes(size_t const bytes);
+
+  /**
+   * @brief This method specifies where the input records the size and the
+   *        hash of the text it reads.
+   *
+   * Only an input created from a stream or file descriptor uses the digest.
+   * The caller of an input created from a text already knows the text.
+   *
+   * @param digest The input resets this digest and adds every byte it reads
+   *               from its stream to it. The value `nullptr` disables the
+   *               digest.
+   */
+  void setDigest(Digest *digest);
 
   /**
-   * @brief This function returns a character that was not consumed yet.
+   * @brief This method checks if the input is larger than the maximum size.
    *
-   * @param offset This variable specifies the index of the character
-   *               this method should retrieve as offset to the last consumed
-   *               character.
+   * @retval true If the whole input is larger than the maximum size set with
+   *              `setMaxBytes`
+   * @retval false Otherwise
+   */
+  bool exceedsMaxBytes() const;
+
+  /**
+   * @brief This function returns a byte that was not consumed yet.
    *
-   * @return A character which is `offset` positions away from the last
-   *         consumed character
+   * @param offset This variable specifies the index of the byte this method
+   *               should retrieve as offset to the last consumed byte.
+   *
+   * @return A byte which is `offset` positions away from the last consumed
+   *         byte
    */
   size_t LA(size_t const offset) const;
 
   /**
-   * @brief This method consumes the next character of `input`.
+   * @brief This method consumes the next byte of `input`.
    */
   void consume();
 
+  /**
+   * @brief This method consumes the given number of bytes of `input`.
+   *
+   * @param bytes This number specifies how many bytes this method consumes.
+   */
+  void consume(size_t const bytes);
+
+  /**
+   * @brief This method returns the number of bytes in front of the next
+   *        newline character.
+   *
+   * The method searches for the newline character in bulk instead of looking
+   * at single bytes.
+   *
+   * @return The number of bytes between the current position and the end of
+   *         the current line (or the end of the input)
+   */
+  size_t lineLength() const;
+
+  /**
+   * @brief This method allows the input to drop the text in front of the
+   *        given offset.
+   *
+   * The input keeps the start of the line containing `offset`, so that it is
+   * still able to determine positions in this line. For an input created from
+   * a text this method does nothing.
+   *
+   * @param offset This parameter specifies the offset of the first byte the
+   *               caller still needs.
+   */
+  void release(size_t const offset);
+
   /**
    * @brief Retrieve the current position inside the input.
    *
-   * @return The current position in number of characters
+   * @return The current position in number of bytes
    */
   size_t index() const;
 
@@ -70,6 +262,69 @@ public:
    *         one character before the current position in the input
    */
   std::string getText(size_t const start) const;
+
+  /**
+   * @brief This method retrieves the text between `start` (inclusive) and
+   *        `end` (exclusive).
+   *
+   * @param start This parameter specifies the start index of the string this
+   *              functions returns.
+   * @param end This parameter specifies the index after the last byte of the
+   *            string this function returns.
+   *
+   * @return A UTF-8 encoded substring of input starting at `start` and ending
+   *         one byte before `end`
+   */
+  std::string getText(size_t const start, size_t const end) const;
+
+  /**
+   * @brief This method appends the text between `start` (inclusive) and
+   *        `end` (exclusive) to a string.
+   *
+   * @param text The method appends the text of the input to this string.
+   * @param start This parameter specifies the start index of the text this
+   *              method appends.
+   * @param end This parameter specifies the index after the last byte of the
+   *            text this method appends.
+   */
+  void appendText(std::string &text, size_t const start,
+                  size_t const end) const;
+
+  /**
+   * @brief This method returns the offset of the first occurrence of a byte
+   *        between `start` (inclusive) and `end` (exclusive).
+   *
+   * @param byte This parameter specifies the byte this method searches for.
+   * @param start This parameter specifies the start index of the search.
+   * @param end This parameter specifies the index after the last byte of the
+   *            search.
+   *
+   * @return The offset of the first byte `byte` in the given range, or `end`
+   *         if the range does not contain `byte`
+   */
+  size_t find(char const byte, size_t const start, size_t const end) const;
+
+  /**
+   * @brief This method returns the column of the byte at the given offset.
+   *
+   * In contrast to the columns returned by `getPosition`, this method counts
+   * bytes instead of characters. This is enough to compare the indentation of
+   * tokens, since indentation only consists of space characters.
+   *
+   * @param offset This parameter specifies the offset of a byte in the input.
+   *
+   * @return The column number (starting at 1) of the given byte
+   */
+  size_t column(size_t const offset) const;
+
+  /**
+   * @brief This method returns the position of the byte at the given offset.
+   *
+   * @param offset This parameter specifies the offset of a byte in the input.
+   *
+   * @return The line and column number (counted in characters) of the byte
+   */
+  Position getPosition(size_t const offset) const;
 };
 
 #endif // ELEKTRA_PLUGIN_YAWN_INPUT_HPP
@@ -8,15 +8,19 @@
 
 // -- Imports ------------------------------------------------------------------
 
-#include <stdexcept>
+#include <algorithm>
+#include <cstdint>
+#include <mutex>
 
 #include "lexer.hpp"
 
-using std::ifstream;
+using std::call_once;
+using std::istream;
 using std::make_pair;
-using std::runtime_error;
+using std::max;
+using std::once_flag;
 using std::string;
-using std::unique_ptr;
+using std::to_string;
 
 #if defined(__clang__)
 using spdlog::set_level;
@@ -25,25 +29,44 @@ using spdlog::stderr_color_mt;
 using spdlog::level::trace;
 #endif
 
-// -- Functions ----------------------------------------------------------------
-
 namespace {
 
+// -- Globals ------------------------------------------------------------------
+
 /**
- * @brief Create a token with the given attributes.
- *
- * @param type This number specifies the type of the created token.
- * @param location This number specifies the location of the token in the
- *                 scanned text.
- * @param text This variable specifies the content that should be stored
- *             in the token.
- *
- * @return A token storing the data provided as arguments to this function
+ * This constant specifies after how many fetches the lexer checks, if the
+ * caller cancelled the conversion.
+ */
+size_t const cancellationInterval = 256;
+
+/**
+ * This constant specifies how many of the last emitted tokens keep their text
+ * after a call of `releaseInput`. The parser reports syntax errors for one of
+ * the last tokens it read.
+ */
+size_t const retainedTokens = 8;
+
+#if defined(__clang__)
+/**
+ * Lexers of parallel conversions start at the same time. This flag makes sure
+ * that only the first lexer registers the logger.
+ */
+once_flag loggerRegistered;
+
+// -- Functions ----------------------------------------------------------------
+
+/**
+ * @brief This function configures spdlog and registers the logger of the
+ *        lexer.
  */
-unique_ptr<Token> createToken(int const type, Location const &location,
-                              string const &text) {
-  return unique_ptr<Token>{new Token{type, location, text}};
+void registerLogger() {
+  set_pattern("[%H:%M:%S:%e] %v ");
+  set_level(trace);
+  if (!spdlog::get("console")) {
+    stderr_color_mt("console");
+  }
 }
+#endif
 
 } // namespace
 
@@ -94,8 +117,65 @@ bool Lexer::isComment(size_t const offset) const {
 }
 
 /**
- * @brief This method consumes characters from the input stream keeping
- *        track of line and column numbers.
+ * @brief This method checks if the current input starts a document marker.
+ *
+ * @param marker This parameter specifies the character of the marker (`-` for
+ *               the start and `.` for the end of a document).
+ *
+ * @retval true If the input starts with three marker characters at the start
+ *              of a line
+ * @retval false Otherwise
+ */
+bool Lexer::isDocumentMarker(char const marker) const {
+  return input.column(input.index()) == 1 && input.LA(1) == size_t(marker) &&
+         input.LA(2) == size_t(marker) && input.LA(3) == size_t(marker) &&
+         (input.LA(4) == ' ' || input.LA(4) == '\n' || input.LA(4) == 0);
+}
+
+/**
+ * @brief This method stops the lexer because of an error in the input.
+ *
+ * Afterwards the lexer only returns the token for the end of the input.
+ *
+ * @param message This argument describes the error.
+ * @param offset This argument specifies the start of the erroneous input.
+ */
+void Lexer::fail(string const &message, size_t const offset) {
+  LOGF("Error: {}", message);
+  // Errors at the end of an input that exceeds the size limit are only a
+  // result of the truncated input. `scanToken` reports the size instead.
+  if (error.empty() && !input.exceedsMaxBytes()) {
+    error = message;
+    errorLocation.begin = input.getPosition(offset);
+    errorLocation.end = input.getPosition(input.index());
+  }
+  done = true;
+}
+
+/**
+ * @brief This method adds a scalar to the token queue, if its length does not
+ *        exceed the limit for scalars.
+ *
+ * @param type This argument specifies the type of the scalar token.
+ * @param start This argument specifies the offset of the first character of
+ *              the scalar.
+ * @param indentation This argument specifies the indentation of the content
+ *                    of a block scalar.
+ */
+void Lexer::addScalar(int const type, size_t const start,
+                      size_t const indentation) {
+  if (limits.maxScalarLength > 0 &&
+      input.index() - start > limits.maxScalarLength) {
+    fail("Scalar exceeds the maximum length of " +
+             to_string(limits.maxScalarLength) + " bytes",
+         start);
+    return;
+  }
+  tokens.push_back(Token{type, start, input.index(), indentation});
+}
+
+/**
+ * @brief This method consumes characters from the input stream.
  *
  * @param characters This parameter specifies the number of characters the
  *                   the function should consume.
@@ -109,11 +189,6 @@ void Lexer::forward(size_t const characters = 1) {
       return;
     }
 
-    location += 1;
-    if (input.LA(1) == '\n') {
-      location.end.column = 1;
-      location.lines();
-    }
     input.consume();
   }
 }
@@ -129,7 +204,7 @@ void Lexer::forward(size_t const characters = 1) {
 void Lexer::addBlockEnd(size_t const lineIndex) {
   while (lineIndex < indents.top()) {
     LOG("Add block end");
-    tokens.push_back(createToken(Token::BLOCK_END, location, "BLOCK END"));
+    tokens.push_back(Token{Token::BLOCK_END, input.index(), input.index()});
     indents.pop();
   }
 }
@@ -140,12 +215,21 @@ void Lexer::addBlockEnd(size_t const lineIndex) {
  *
  * @param lineIndex This parameter specifies the indentation value that this
  *                  function compares to the current indentation.
+ * @param offset This parameter specifies the start of the token that opens
+ *               the new block collection.
  *
  * @retval true If the function added an indentation value
  * @retval false Otherwise
  */
-bool Lexer::addIndentation(size_t const lineIndex) {
+bool Lexer::addIndentation(size_t const lineIndex, size_t const offset) {
   if (lineIndex > indents.top()) {
+    // The stack contains an additional value for the indentation of the root
+    if (limits.maxDepth > 0 && indents.size() > limits.maxDepth) {
+      fail("Input exceeds the maximum nesting depth of " +
+               to_string(limits.maxDepth),
+           offset);
+      return false;
+    }
     LOGF("Add indentation {}", lineIndex);
     indents.push(lineIndex);
     return true;
@@ -158,8 +242,10 @@ bool Lexer::addIndentation(size_t const lineIndex) {
  *        current input position.
  */
 void Lexer::addSimpleKeyCandidate() {
-  size_t position = tokens.size() + emitted.size();
-  simpleKey = make_pair(createToken(Token::KEY, location, "KEY"), position);
+  size_t position = tokens.size() + scanned;
+  simpleKey =
+      make_pair(Token{Token::KEY, input.index(), input.index()}, position);
+  simpleKeyExists = true;
 }
 
 /**
@@ -173,12 +259,13 @@ bool Lexer::needMoreTokens() const {
     return false;
   }
 
-  bool keyCandidateExists = simpleKey.first != nullptr;
-  return keyCandidateExists || tokens.empty();
+  return simpleKeyExists || tokens.empty();
 }
 
 /**
  * @brief This method removes uninteresting characters from the input.
+ *
+ * If the lexer skips comments, then this method also removes comments.
  */
 void Lexer::scanToNextToken() {
   LOG("Scan to next token");
@@ -188,6 +275,10 @@ void Lexer::scanToNextToken() {
       forward();
     }
     LOG("Skipped whitespace");
+    // Comments outside of a document do not belong to any node
+    if ((skipComments || !documentOpen) && input.LA(1) == '#') {
+      skipComment();
+    }
     if (input.LA(1) == '\n') {
       forward();
       LOG("Skipped newline");
@@ -202,30 +293,56 @@ void Lexer::scanToNextToken() {
  * @brief This method adds new tokens to the token queue.
  */
 void Lexer::fetchTokens() {
+  if (limits.cancellation && ++fetched % cancellationInterval == 0 &&
+      limits.cancellation->isCancelled()) {
+    fail("Conversion cancelled", input.index());
+    return;
+  }
+
   scanToNextToken();
-  location.step();
-  addBlockEnd(location.begin.column);
-  LOGF("Fetch new token at location: {}:{}", location.begin.line,
-       location.begin.column);
+  if (isDocumentMarker('-')) {
+    scanDocumentStart();
+    return;
+  } else if (isDocumentMarker('.')) {
+    scanDocumentEnd();
+    return;
+  }
+  addBlockEnd(input.column(input.index()));
+  LOGF("Fetch new token at location: {}:{}",
+       input.getPosition(input.index()).line,
+       input.getPosition(input.index()).column);
 
   if (input.LA(1) == 0) {
     scanEnd();
     return;
-  } else if (isValue()) {
+  } else if (input.LA(1) == '#') {
+    scanComment();
+    return;
+  }
+
+  if (!documentOpen) {
+    // Content after the end of a document starts a new document
+    tokens.push_back(
+        Token{Token::DOCUMENT_START, input.index(), input.index()});
+    documentOpen = true;
+  }
+  documentContent = true;
+
+  if (isValue()) {
     scanValue();
     return;
   } else if (isElement()) {
     scanElement();
     return;
+  } else if (input.LA(1) == '|' || input.LA(1) == '>') {
+    scanBlockScalar();
+    return;
   } else if (input.LA(1) == '"') {
     scanDoubleQuotedScalar();
     return;
   } else if (input.LA(1) == '\'') {
     scanSingleQuotedScalar();
     return;
-  } else if (input.LA(1) == '#') {
-    scanComment();
-    return;
   }
 
   scanPlainScalar();
@@ -237,7 +354,10 @@ void Lexer::fetchTokens() {
  */
 void Lexer::scanStart() {
   LOG("Scan start token");
-  tokens.push_back(createToken(Token::STREAM_START, location, "STREAM START"));
+  tokens.push_back(Token{Token::STREAM_START, input.index(), input.index()});
+  // Every stream contains at least one (implicit) document
+  tokens.push_back(Token{Token::DOCUMENT_START, input.index(), input.index()});
+  documentOpen = true;
 }
 
 /**
@@ -247,11 +367,54 @@ void Lexer::scanStart() {
 void Lexer::scanEnd() {
   LOG("Scan end token");
   addBlockEnd(0);
-  tokens.push_back(createToken(Token::STREAM_END, location, "STREAM END"));
-  tokens.push_back(createToken(-1, location, "EOF"));
+  if (documentOpen) {
+    tokens.push_back(Token{Token::DOCUMENT_END, input.index(), input.index()});
+    documentOpen = false;
+  }
+  tokens.push_back(Token{Token::STREAM_END, input.index(), input.index()});
+  tokens.push_back(Token{-1, input.index(), input.index()});
   done = true;
 }
 
+/**
+ * @brief This method scans a document start marker (`---`) and adds the
+ *        tokens for the document boundary to the token queue.
+ */
+void Lexer::scanDocumentStart() {
+  LOG("Scan document start");
+  addBlockEnd(0);
+  simpleKeyExists = false; // A simple key never spans multiple documents
+  size_t start = input.index();
+  forward(3);
+  if (documentOpen && !documentContent) {
+    // The marker explicitly starts the (so far empty) current document
+    return;
+  }
+  if (documentOpen) {
+    tokens.push_back(Token{Token::DOCUMENT_END, start, start});
+  }
+  tokens.push_back(Token{Token::DOCUMENT_START, start, input.index()});
+  documentOpen = true;
+  documentContent = false;
+}
+
+/**
+ * @brief This method scans a document end marker (`...`) and adds it to the
+ *        token queue.
+ */
+void Lexer::scanDocumentEnd() {
+  LOG("Scan document end");
+  addBlockEnd(0);
+  simpleKeyExists = false;
+  size_t start = input.index();
+  forward(3);
+  if (documentOpen) {
+    tokens.push_back(Token{Token::DOCUMENT_END, start, input.index()});
+    documentOpen = false;
+    documentContent = false;
+  }
+}
+
 /**
  * @brief This method scans a single quoted scalar and adds it to the token
  *        queue.
@@ -265,11 +428,15 @@ void Lexer::scanSingleQuotedScalar() {
 
   forward(); // Include initial single quote
   while (input.LA(1) != '\'' || input.LA(2) == '\'') {
-    forward();
+    if (input.LA(1) == 0) {
+      fail("Unterminated single quoted scalar", start);
+      return;
+    }
+    // Skip escaped single quotes (`''`) as a whole
+    forward(input.LA(1) == '\'' ? 2 : 1);
   }
   forward(); // Include closing single quote
-  tokens.push_back(
-      createToken(Token::SINGLE_QUOTED_SCALAR, location, input.getText(start)));
+  addScalar(Token::SINGLE_QUOTED_SCALAR, start);
 }
 
 /**
@@ -285,11 +452,101 @@ void Lexer::scanDoubleQuotedScalar() {
 
   forward(); // Include initial double quote
   while (input.LA(1) != '"') {
-    forward();
+    if (input.LA(1) == 0) {
+      fail("Unterminated double quoted scalar", start);
+      return;
+    }
+    // Skip escaped characters such as `\"`
+    forward(input.LA(1) == '\\' && input.LA(2) != 0 ? 2 : 1);
   }
   forward(); // Include closing double quote
-  tokens.push_back(
-      createToken(Token::DOUBLE_QUOTED_SCALAR, location, input.getText(start)));
+  addScalar(Token::DOUBLE_QUOTED_SCALAR, start);
+}
+
+/**
+ * @brief This method scans a literal or folded block scalar and adds it to the
+ *        token queue.
+ *
+ * The lexer only determines the extent of the scalar. For each line it looks
+ * at the indentation and then skips the rest of the line in bulk. The token
+ * stores the indentation of the content, which allows the listener to remove
+ * the indentation, fold lines and apply the chomping indicator, when it
+ * creates the value of the scalar.
+ */
+void Lexer::scanBlockScalar() {
+  LOG("Scan block scalar");
+  size_t const start = input.index();
+  int const type =
+      input.LA(1) == '|' ? Token::LITERAL_SCALAR : Token::FOLDED_SCALAR;
+  // A block scalar ends the line of a simple key candidate
+  simpleKeyExists = false;
+  forward();
+
+  // The chomping and indentation indicators may appear in any order
+  bool chomping = false;
+  size_t increment = 0;
+  for (size_t indicator = 0; indicator < 2; indicator++) {
+    if (!chomping && (input.LA(1) == '-' || input.LA(1) == '+')) {
+      chomping = true;
+      forward();
+    } else if (increment == 0 && input.LA(1) >= '1' && input.LA(1) <= '9') {
+      increment = input.LA(1) - '0';
+      forward();
+    }
+  }
+  size_t const separator = countPlainSpace();
+  forward(separator);
+  // The lexer drops comments after the header, since they precede the token
+  if (separator > 0 && input.LA(1) == '#') {
+    skipComment();
+  }
+  if (input.LA(1) != '\n' && input.LA(1) != 0) {
+    fail("Invalid block scalar header", start);
+    return;
+  }
+  forward();
+
+  // The content has to be indented more than the surrounding collection
+  size_t const minimum = indents.top();
+  size_t indentation = increment > 0 ? minimum + increment - 1 : 0;
+  bool detect = increment == 0;
+  size_t leading = 0;
+  while (input.LA(1) != 0) {
+    size_t const spaces = countPlainSpace();
+    if (spaces == 0 && (isDocumentMarker('-') || isDocumentMarker('.'))) {
+      break;
+    }
+    size_t const next = input.LA(spaces + 1);
+    if (next != '\n' && next != 0) {
+      if (detect && spaces >= minimum) {
+        // The first non-empty line determines the indentation
+        if (spaces < leading) {
+          fail("Leading empty line of block scalar contains too many spaces",
+               input.index());
+          return;
+        }
+        indentation = spaces;
+        detect = false;
+      }
+      if (detect || spaces < indentation) {
+        break;
+      }
+    } else if (detect) {
+      leading = max(leading, spaces);
+    }
+
+    size_t const length = input.lineLength();
+    input.consume(input.LA(length + 1) == '\n' ? length + 1 : length);
+    if (limits.maxScalarLength > 0 &&
+        input.index() - start > limits.maxScalarLength) {
+      break; // `addScalar` reports the error
+    }
+  }
+  if (detect) {
+    // A scalar without content only contains empty lines
+    indentation = max(minimum, leading);
+  }
+  addScalar(type, start, indentation);
 }
 
 /**
@@ -313,8 +570,7 @@ void Lexer::scanPlainScalar() {
     lengthSpace = countPlainSpace();
   }
 
-  tokens.push_back(
-      createToken(Token::PLAIN_SCALAR, location, input.getText(start)));
+  addScalar(Token::PLAIN_SCALAR, start);
 }
 
 /**
@@ -364,10 +620,22 @@ size_t Lexer::countPlainSpace() const {
 void Lexer::scanComment() {
   LOG("Scan comment");
   size_t start = input.index();
-  while (input.LA(1) != '\n') {
+  // The last line of the input does not need to end with a newline character
+  while (input.LA(1) != '\n' && input.LA(1) != 0) {
+    forward();
+  }
+  tokens.push_back(Token{Token::COMMENT, start, input.index()});
+}
+
+/**
+ * @brief This method consumes the characters of a comment without creating
+ *        a token.
+ */
+void Lexer::skipComment() {
+  LOG("Skip comment");
+  while (input.LA(1) != '\n' && input.LA(1) != 0) {
     forward();
   }
-  tokens.push_back(createToken(Token::COMMENT, location, input.getText(start)));
 }
 
 /**
@@ -377,21 +645,19 @@ void Lexer::scanComment() {
 void Lexer::scanValue() {
   LOG("Scan value");
   forward(1);
-  tokens.push_back(
-      createToken(Token::VALUE, location, input.getText(input.index() - 1)));
+  tokens.push_back(Token{Token::VALUE, input.index() - 1, input.index()});
   forward(1);
-  if (simpleKey.first == nullptr) {
-    throw runtime_error("Unable to locate key for value");
-  }
-  size_t offset = simpleKey.second - emitted.size();
-  auto key = move(simpleKey.first);
-  auto start = key->getStart();
-  tokens.insert(tokens.begin() + offset, move(key));
-  simpleKey.first = nullptr; // Remove key candidate
-  if (addIndentation(start.column)) {
-    location.begin = start;
+  if (!simpleKeyExists) {
+    fail("Unable to locate key for value", input.index() - 2);
+    return;
+  }
+  size_t offset = simpleKey.second - scanned;
+  Token key = simpleKey.first;
+  tokens.insert(tokens.begin() + offset, key);
+  simpleKeyExists = false; // Remove key candidate
+  if (addIndentation(input.column(key.getBegin()), key.getBegin())) {
     tokens.insert(tokens.begin() + offset,
-                  createToken(Token::MAPPING_START, location, "MAPPING START"));
+                  Token{Token::MAPPING_START, key.getBegin(), key.getBegin()});
   }
 }
 
@@ -401,13 +667,12 @@ void Lexer::scanValue() {
  */
 void Lexer::scanElement() {
   LOG("Scan element");
-  if (addIndentation(location.end.column)) {
+  if (addIndentation(input.column(input.index()), input.index())) {
     tokens.push_back(
-        createToken(Token::SEQUENCE_START, location, "SEQUENCE START"));
+        Token{Token::SEQUENCE_START, input.index(), input.index()});
   }
   forward(1);
-  tokens.push_back(
-      createToken(Token::ELEMENT, location, input.getText(input.index() - 1)));
+  tokens.push_back(Token{Token::ELEMENT, input.index() - 1, input.index()});
   forward(1);
 }
 
@@ -418,13 +683,30 @@ void Lexer::scanElement() {
 /**
  * @brief This constructor initializes a lexer with the given input.
  *
+ * The lexer reads the stream incrementally. The stream therefore has to stay
+ * valid as long as the lexer scans tokens.
+ *
  * @param stream This stream specifies the text which this lexer analyzes.
+ * @param options This argument stores settings that change which tokens
+ *                the lexer emits.
  */
-Lexer::Lexer(ifstream &stream) : input{stream} {
+Lexer::Lexer(istream &stream, Options const &options)
+    : Lexer{Input{stream}, options} {}
+
+/**
+ * @brief This constructor initializes a lexer with the given input.
+ *
+ * @param text This argument specifies the text which this lexer analyzes.
+ * @param options This argument stores settings that change which tokens
+ *                the lexer emits.
+ */
+Lexer::Lexer(Input const &text, Options const &options)
+    : input{text}, skipComments{options.skipComments}, limits{options} {
+  input.setMaxBytes(options.maxBytes);
+  input.setDigest(options.digest);
 #if defined(__clang__)
-  set_pattern("[%H:%M:%S:%e] %v ");
-  set_level(trace);
-  console = stderr_color_mt("console");
+  call_once(loggerRegistered, registerLogger);
+  console = spdlog::get("console");
 #endif
   LOG("Init lexer");
 
@@ -443,24 +725,218 @@ Lexer::Lexer(ifstream &stream) : input{stream} {
  * @return A number specifying the type of the first token the parser has not
  *         emitted yet
  */
-int Lexer::nextToken(void **attribute) {
+int Lexer::nextToken(void **attribute) { return emit(scanToken(), attribute); }
+
+/**
+ * @brief This method scans the next token without handing it to the parser.
+ *
+ * This method and `emit` do not share any data. A lexer can therefore scan
+ * tokens in one thread, while another thread emits them.
+ *
+ * @return The next token of the input, or a token of type `-1`, if the
+ *         lexer found the end of the input
+ */
+Token Lexer::scanToken() {
   while (needMoreTokens()) {
     fetchTokens();
   }
+  if (input.exceedsMaxBytes() && error.empty()) {
+    done = true;
+    error = "Input exceeds the maximum size of " +
+            to_string(limits.maxBytes) + " bytes";
+    errorLocation.begin = input.getPosition(input.index());
+    errorLocation.end = errorLocation.begin;
+  }
+  if (limits.maxTokens > 0 && scanned >= limits.maxTokens && !tokens.empty() &&
+      tokens.front().getType() != -1) {
+    fail("Input exceeds the maximum number of " +
+             to_string(limits.maxTokens) + " tokens",
+         tokens.front().getBegin());
+  }
+  if (!error.empty()) {
+    // Hand the end of the input to the parser, which then stops
+    Token token{-1, input.index(), input.index()};
+    return token;
+  }
+  peakQueueSize = max(peakQueueSize, tokens.size());
+#if defined(__clang__)
   string output;
   output += "\n\nTokens:\n";
   for (auto const &token : tokens) {
-    output += "\t" + to_string(*token) + "\n";
+    output += "\t" + toString(token) + "\n";
   }
   LOG(output);
+#endif
 
   if (tokens.size() <= 0) {
-    tokens.push_front(createToken(-1, location, "EOF"));
+    tokens.push_front(Token{-1, input.index(), input.index()});
   }
 
-  emitted.push_back(move(tokens.front()));
+  Token token = tokens.front();
   tokens.pop_front();
+  scanned++;
+  return token;
+}
+
+/**
+ * @brief This method hands a scanned token to the parser.
+ *
+ * @param token This argument specifies a token returned by `scanToken`.
+ * @param attribute The parser uses this parameter to store auxiliary data for
+ *                  the returned token.
+ *
+ * @return The type of the given token
+ */
+int Lexer::emit(Token const &token, void **attribute) {
+  emitted.push_back(token);
+  *attribute = reinterpret_cast<void *>(
+      static_cast<uintptr_t>(emitted.size() - 1));
+  return token.getType();
+}
 
-  *attribute = &emitted.back();
-  return emitted.back()->getType();
+/**
+ * @brief This method allows the lexer to drop the input in front of the
+ *        tokens it handed to the parser last.
+ *
+ * Afterwards the lexer is only able to determine the text and location of the
+ * last few emitted tokens and all later tokens.
+ */
+void Lexer::releaseInput() {
+  if (emitted.size() > retainedTokens) {
+    input.release(emitted[emitted.size() - retainedTokens].getBegin());
+  }
+}
+
+/**
+ * @brief This method drops all tokens the lexer handed to the parser and the
+ *        input in front of the tokens it did not hand out yet.
+ *
+ * Afterwards the attributes of all previously emitted tokens are invalid. The
+ * converter uses this method after it converted a document.
+ */
+void Lexer::discardEmitted() {
+  emitted.clear();
+  input.release(tokens.empty() ? input.index() : tokens.front().getBegin());
+}
+
+/**
+ * @brief This method returns the token the lexer handed to the parser
+ *        together with the given attribute.
+ *
+ * @param attribute This parameter stores auxiliary data `nextToken` passed
+ *                  to the parser.
+ *
+ * @return The emitted token referenced by `attribute`
+ */
+Token const &Lexer::getToken(void const *attribute) const {
+  return emitted[reinterpret_cast<uintptr_t>(attribute)];
+}
+
+/**
+ * @brief This method returns all tokens the lexer handed to the parser.
+ *
+ * @return A list containing the emitted tokens in the order of the input
+ */
+std::vector<Token> const &Lexer::getTokens() const { return emitted; }
+
+/**
+ * @brief This method returns the maximum size of the token queue.
+ *
+ * The lexer has to keep tokens in its queue until it knows that it does not
+ * need to insert a token in front of them.
+ *
+ * @return The maximum number of tokens the lexer stored in its queue
+ */
+size_t Lexer::getPeakQueueSize() const { return peakQueueSize; }
+
+/**
+ * @brief This method returns a description of the first error of the input.
+ *
+ * @return A text describing the error, or an empty text, if the lexer did not
+ *         find any errors
+ */
+string const &Lexer::getError() const { return error; }
+
+/**
+ * @brief This method returns the location of the first error of the input.
+ *
+ * @return The start and end position of the error
+ */
+Location Lexer::getErrorLocation() const { return errorLocation; }
+
+/**
+ * @brief This method returns the content of a token.
+ *
+ * @param token This argument specifies a token emitted by this lexer.
+ *
+ * @return The text stored inside the given token
+ */
+string Lexer::getText(Token const &token) const {
+  if (token.getType() != Token::LITERAL_SCALAR &&
+      token.getType() != Token::FOLDED_SCALAR) {
+    return input.getText(token.getBegin(), token.getEnd());
+  }
+
+  // We replace the header of a block scalar by a canonical header, which
+  // contains the style, the chomping indicator (or a space) and the
+  // indentation of the content. The content itself stays unchanged.
+  size_t const newline =
+      input.find('\n', token.getBegin(), token.getEnd());
+  string const header = input.getText(token.getBegin(), newline);
+  char chomping = ' ';
+  for (size_t indicator = 1; indicator < 3 && indicator < header.size();
+       indicator++) {
+    if (header[indicator] == '-' || header[indicator] == '+') {
+      chomping = header[indicator];
+    }
+  }
+  string text{header[0], chomping};
+  text += to_string(token.getIndentation());
+  text += '\n';
+  if (newline < token.getEnd()) {
+    text.reserve(text.size() + token.getEnd() - newline - 1);
+    input.appendText(text, newline + 1, token.getEnd());
+  }
+  return text;
+}
+
+/**
+ * @brief This method returns the column of the first byte of a token.
+ *
+ * @param token This argument specifies a token emitted by this lexer.
+ *
+ * @return The column number (counted in bytes, starting at 1) of `token`
+ */
+size_t Lexer::getColumn(Token const &token) const {
+  return input.column(token.getBegin());
+}
+
+/**
+ * @brief This method returns the location of a token in the input.
+ *
+ * @param token This argument specifies a token emitted by this lexer.
+ *
+ * @return The start and end position of the given token
+ */
+Location Lexer::getLocation(Token const &token) const {
+  Location range;
+  range.begin = input.getPosition(token.getBegin());
+  range.end = input.getPosition(token.getEnd());
+  return range;
+}
+
+/**
+ * @brief This method returns a string representation of a token including
+ *        its content and location.
+ *
+ * @param token This argument specifies a token emitted by this lexer.
+ *
+ * @return A text describing the given token
+ */
+string Lexer::toString(Token const &token) const {
+  auto const range = getLocation(token);
+  return "<Token, " + typeToString(token.getType()) + ", " + getText(token) +
+         ", " + to_string(range.begin.line) + ":" +
+         to_string(range.begin.column) + "–" + to_string(range.end.line) + ":" +
+         to_string(range.end.column) + ">";
 }
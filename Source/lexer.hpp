@@ -29,11 +29,14 @@
 // -- Imports ------------------------------------------------------------------
 
 #include <deque>
-#include <fstream>
+#include <istream>
 #include <memory>
 #include <stack>
+#include <vector>
 
 #include "input.hpp"
+#include "location.hpp"
+#include "options.hpp"
 #include "token.hpp"
 
 #if defined(__clang__)
@@ -52,19 +55,17 @@ class Lexer {
   Input input;
 
   /** This queue stores the list of tokens produced by the lexer. */
-  std::deque<std::unique_ptr<Token>> tokens;
+  std::deque<Token> tokens;
 
   /**
    * This variable stores tokens already emitted by the parser. We keep this
    * list, since the syntax tree produced by YAEP only stores references to
    * tokens. As a consequence we need to keep the referenced tokens in
    * memory, as long as other code accesses the token attributes of the syntax
-   * tree.
+   * tree. Since the vector might move its content, the parser references a
+   * token by its index in this list.
    */
-  std::deque<std::unique_ptr<Token>> emitted;
-
-  /** This variable stores the current line and column number. */
-  Location location;
+  std::vector<Token> emitted;
 
   /**
    * This stack stores the indentation (in number of characters) for each
@@ -80,7 +81,13 @@ class Lexer {
    * use a single token here. If we need support for flow collections we have
    * to store a candidate for each flow level (block context = flow level 0).
    */
-  std::pair<std::unique_ptr<Token>, size_t> simpleKey;
+  std::pair<Token, size_t> simpleKey;
+
+  /**
+   * This boolean specifies if `simpleKey` currently stores a simple key
+   * candidate or not.
+   */
+  bool simpleKeyExists = false;
 
   /**
    * This boolean specifies if the lexer has already scanned the whole input or
@@ -88,6 +95,54 @@ class Lexer {
    */
   bool done = false;
 
+  /**
+   * This boolean specifies if the lexer emitted the start of a document, but
+   * not its end.
+   */
+  bool documentOpen = false;
+
+  /**
+   * This boolean specifies if the current document contains any tokens except
+   * for comments.
+   */
+  bool documentContent = false;
+
+  /**
+   * This boolean specifies if the lexer drops comments instead of adding them
+   * to the token queue.
+   */
+  bool skipComments = false;
+
+  /**
+   * This variable stores the maximum number of tokens the queue `tokens`
+   * contained before the lexer emitted a token.
+   */
+  size_t peakQueueSize = 0;
+
+  /**
+   * This variable stores the number of tokens the lexer removed from the
+   * token queue.
+   */
+  size_t scanned = 0;
+
+  /**
+   * This variable stores the limits the lexer enforces for its input and the
+   * token, which specifies if the lexer should stop.
+   */
+  Options limits;
+
+  /** This variable stores how often the lexer fetched new tokens. */
+  size_t fetched = 0;
+
+  /**
+   * This variable stores a description of the first error the lexer found.
+   * If the input does not contain any errors, then this text is empty.
+   */
+  std::string error;
+
+  /** This variable stores the location of the first error of the input. */
+  Location errorLocation;
+
 #if defined(__clang__)
   /**
    * This variable stores the logger used by the lexer to print debug messages.
@@ -128,8 +183,43 @@ class Lexer {
   bool isComment(size_t const offset) const;
 
   /**
-   * @brief This method consumes characters from the input stream keeping
-   *        track of line and column numbers.
+   * @brief This method checks if the current input starts a document marker.
+   *
+   * @param marker This parameter specifies the character of the marker
+   *               (`-` for the start and `.` for the end of a document).
+   *
+   * @retval true If the input starts with three marker characters at the
+   *              start of a line
+   * @retval false Otherwise
+   */
+  bool isDocumentMarker(char const marker) const;
+
+
+  /**
+   * @brief This method stops the lexer because of an error in the input.
+   *
+   * Afterwards the lexer only returns the token for the end of the input.
+   *
+   * @param message This argument describes the error.
+   * @param offset This argument specifies the start of the erroneous input.
+   */
+  void fail(std::string const &message, size_t const offset);
+
+  /**
+   * @brief This method adds a scalar to the token queue, if its length does
+   *        not exceed the limit for scalars.
+   *
+   * @param type This argument specifies the type of the scalar token.
+   * @param start This argument specifies the offset of the first character of
+   *              the scalar.
+   * @param indentation This argument specifies the indentation of the
+   *                    content of a block scalar.
+   */
+  void addScalar(int const type, size_t const start,
+                 size_t const indentation = 0);
+
+  /**
+   * @brief This method consumes characters from the input stream.
    *
    * @param characters This parameter specifies the number of characters the
    *                   the function should consume.
@@ -152,11 +242,13 @@ class Lexer {
    *
    * @param lineIndex This parameter specifies the indentation value that this
    *                  function compares to the current indentation.
+   * @param offset This parameter specifies the start of the token that opens
+   *               the new block collection.
    *
    * @retval true If the function added an indentation value
    * @retval false Otherwise
    */
-  bool addIndentation(size_t const column);
+  bool addIndentation(size_t const column, size_t const offset);
 
   /**
    * @brief This method saves a token for a simple key candidate located at the
@@ -166,6 +258,8 @@ class Lexer {
 
   /**
    * @brief This method removes uninteresting characters from the input.
+   *
+   * If the lexer skips comments, then this method also removes comments.
    */
   void scanToNextToken();
 
@@ -194,6 +288,18 @@ class Lexer {
    */
   void scanEnd();
 
+  /**
+   * @brief This method scans a document start marker (`---`) and adds the
+   *        tokens for the document boundary to the token queue.
+   */
+  void scanDocumentStart();
+
+  /**
+   * @brief This method scans a document end marker (`...`) and adds it to the
+   *        token queue.
+   */
+  void scanDocumentEnd();
+
   /**
    * @brief This method scans a single quoted scalar and adds it to the token
    *        queue.
@@ -206,6 +312,12 @@ class Lexer {
    */
   void scanDoubleQuotedScalar();
 
+  /**
+   * @brief This method scans a literal or folded block scalar and adds it to
+   *        the token queue.
+   */
+  void scanBlockScalar();
+
   /**
    * @brief This method scans a plain scalar and adds it to the token queue.
    */
@@ -236,6 +348,12 @@ class Lexer {
    */
   void scanComment();
 
+  /**
+   * @brief This method consumes the characters of a comment without creating
+   *        a token.
+   */
+  void skipComment();
+
   /**
    * @brief This method scans a mapping value token and adds it to the token
    *        queue.
@@ -252,9 +370,23 @@ public:
   /**
    * @brief This constructor initializes a lexer with the given input.
    *
+   * The lexer reads the stream incrementally. The stream therefore has to
+   * stay valid as long as the lexer scans tokens.
+   *
    * @param stream This stream specifies the text which this lexer analyzes.
+   * @param options This argument stores settings that change which tokens
+   *                the lexer emits.
    */
-  Lexer(std::ifstream &stream);
+  Lexer(std::istream &stream, Options const &options = Options{});
+
+  /**
+   * @brief This constructor initializes a lexer with the given input.
+   *
+   * @param text This argument specifies the text which this lexer analyzes.
+   * @param options This argument stores settings that change which tokens
+   *                the lexer emits.
+   */
+  Lexer(Input const &text, Options const &options = Options{});
 
   /**
    * @brief This method returns the next token produced by the lexer.
@@ -268,6 +400,126 @@ public:
    *         emitted yet
    */
   int nextToken(void **attribute);
+
+  /**
+   * @brief This method scans the next token without handing it to the parser.
+   *
+   * This method and `emit` do not share any data. A lexer can therefore scan
+   * tokens in one thread, while another thread emits them.
+   *
+   * @return The next token of the input, or a token of type `-1`, if the
+   *         lexer found the end of the input
+   */
+  Token scanToken();
+
+  /**
+   * @brief This method hands a scanned token to the parser.
+   *
+   * @param token This argument specifies a token returned by `scanToken`.
+   * @param attribute The parser uses this parameter to store auxiliary data
+   *                  for the returned token.
+   *
+   * @return The type of the given token
+   */
+  int emit(Token const &token, void **attribute);
+
+  /**
+   * @brief This method allows the lexer to drop the input in front of the
+   *        tokens it handed to the parser last.
+   *
+   * Afterwards the lexer is only able to determine the text and location of
+   * the last few emitted tokens and all later tokens.
+   */
+  void releaseInput();
+
+  /**
+   * @brief This method drops all tokens the lexer handed to the parser and
+   *        the input in front of the tokens it did not hand out yet.
+   *
+   * Afterwards the attributes of all previously emitted tokens are invalid.
+   * The converter uses this method after it converted a document.
+   */
+  void discardEmitted();
+
+  /**
+   * @brief This method returns the token the lexer handed to the parser
+   *        together with the given attribute.
+   *
+   * @param attribute This parameter stores auxiliary data `nextToken` passed
+   *                  to the parser.
+   *
+   * @return The emitted token referenced by `attribute`
+   */
+  Token const &getToken(void const *attribute) const;
+
+  /**
+   * @brief This method returns all tokens the lexer handed to the parser.
+   *
+   * @return A list containing the emitted tokens in the order of the input
+   */
+  std::vector<Token> const &getTokens() const;
+
+  /**
+   * @brief This method returns the maximum size of the token queue.
+   *
+   * The lexer has to keep tokens in its queue until it knows that it does
+   * not need to insert a token in front of them.
+   *
+   * @return The maximum number of tokens the lexer stored in its queue
+   */
+  size_t getPeakQueueSize() const;
+
+  /**
+   * @brief This method returns a description of the first error of the input.
+   *
+   * @return A text describing the error, or an empty text, if the lexer did
+   *         not find any errors
+   */
+  std::string const &getError() const;
+
+  /**
+   * @brief This method returns the location of the first error of the input.
+   *
+   * @return The start and end position of the error
+   */
+  Location getErrorLocation() const;
+
+  /**
+   * @brief This method returns the content of a token.
+   *
+   * @param token This argument specifies a token emitted by this lexer.
+   *
+   * @return The text stored inside the given token
+   */
+  std::string getText(Token const &token) const;
+
+  /**
+   * @brief This method returns the column of the first byte of a token.
+   *
+   * @param token This argument specifies a token emitted by this lexer.
+   *
+   * @return The column number (counted in bytes, starting at 1) of `token`
+   */
+  size_t getColumn(Token const &token) const;
+
+  /**
+   * @brief This method returns the location of a token in the input.
+   *
+   * @param token This argument specifies a token emitted by this lexer.
+   *
+   * @return The start and end position of the given token
+   */
+  Location getLocation(Token const &token) const;
+
+  /**
+   * @brief This method returns a string representation of a token including
+   *        its content and location.
+   *
+   * @param token This argument specifies a token emitted by this lexer.
+   *
+   * @return A text describing the given token
+   */
+  std::string toString(Token const &token) const;
 };
 
 #endif // ELEKTRA_PLUGIN_YAWN_LEXER_HPP
@@ -0,0 +1,325 @@
+/**
+ * @file
+ *
+ * @brief This file contains the C interface of the YAML to `KeySet`
+ *        converter library.
+ *
+ * @copyright BSD License (see LICENSE.md or https://www.libelektra.org)
+ */
+
+// -- Imports ------------------------------------------------------------------
+
+#include <chrono>
+#include <exception>
+#include <new>
+#include <string>
+
+#include <kdb.hpp>
+
+#include "convert.hpp"
+#include "libyawn.h"
+
+using std::exception;
+using std::nothrow;
+using std::string;
+using std::chrono::milliseconds;
+
+using ckdb::YawnLimit;
+using ckdb::YawnOptions;
+
+// -- Class --------------------------------------------------------------------
+
+/** This structure stores the settings of the converter. */
+struct ckdb::_YawnOptions {
+  /** This variable stores the settings the converter uses. */
+  Options options;
+
+  /**
+   * This number specifies the maximum duration of a single conversion. The
+   * value `0` disables the timeout.
+   */
+  milliseconds timeout{0};
+};
+
+namespace {
+
+// -- Functions ----------------------------------------------------------------
+
+/**
+ * @brief This function stores the description of an error in the metadata
+ *        of the given key.
+ *
+ * @param key The function adds the error metadata to this key.
+ * @param reason This text describes the error.
+ */
+void setError(kdb::Key &key, string const &reason) {
+  key.setMeta("error/module", "yawn");
+  key.setMeta("error/reason", reason);
+}
+
+/**
+ * @brief This function runs a conversion with the given settings and keeps
+ *        exceptions from crossing the C interface.
+ *
+ * If the conversion fails, then the function stores a description of the
+ * error in the metadata `error/reason` of `parentKey`.
+ *
+ * @param keySet The conversion adds the converted keys to this key set.
+ * @param parentKey The conversion stores the converted keys below this key.
+ * @param options This argument stores the settings of the converter. If it
+ *                is `nullptr`, then the function uses the default settings.
+ * @param conversion This function converts the input to keys.
+ *
+ * @return The value returned by `conversion`, or `-1` if it threw an
+ *         exception
+ */
+template <typename Conversion>
+int run(ckdb::KeySet *keySet, ckdb::Key *parentKey,
+        YawnOptions const *options, Conversion const &conversion) {
+  if (!keySet || !parentKey) {
+    return -1;
+  }
+
+  Options settings = options ? options->options : Options{};
+  string error;
+  settings.error = &error;
+  Cancellation cancellation;
+  if (options && options->timeout.count() > 0) {
+    cancellation.setDeadline(Cancellation::Clock::now() + options->timeout);
+    settings.cancellation = &cancellation;
+  }
+
+  // The C++ wrappers take over the given key set and key. We release them
+  // again before we return.
+  kdb::KeySet keys{keySet};
+  kdb::Key parent{parentKey};
+  int status = -1;
+  try {
+    status = conversion(keys, parent, settings);
+    if (status == -3) {
+      setError(parent, "The conversion exceeded the timeout");
+    } else if (status < 0) {
+      setError(parent, error);
+    }
+  } catch (exception const &failure) {
+    status = -1;
+    try {
+      setError(parent, string{"Unable to convert input: "} + failure.what());
+    } catch (...) {
+    }
+  } catch (...) {
+    status = -1;
+  }
+  parent.release();
+  keys.release();
+  return status;
+}
+
+} // namespace
+
+/**
+ * @brief This function returns the version of the interface implemented by
+ *        the linked library.
+ *
+ * @return The value of `YAWN_API_VERSION` the library was compiled with
+ */
+int ckdb::yawnVersion(void) { return YAWN_API_VERSION; }
+
+/**
+ * @brief This function creates settings with the default values of the
+ *        converter.
+ *
+ * @return New settings the caller has to free with `yawnOptionsDel`, or
+ *         `NULL` if there was not enough memory
+ */
+YawnOptions *ckdb::yawnOptionsNew(void) { return new (nothrow) YawnOptions; }
+
+/**
+ * @brief This function creates settings that convert well formed input as
+ *        fast as possible.
+ *
+ * @return New settings the caller has to free with `yawnOptionsDel`, or
+ *         `NULL` if there was not enough memory
+ */
+YawnOptions *ckdb::yawnOptionsNewProduction(void) {
+  auto options = new (nothrow) YawnOptions;
+  if (options) {
+    options->options = Options::production();
+  }
+  return options;
+}
+
+/**
+ * @brief This function frees the given settings.
+ *
+ * @param options This argument stores the settings this function frees. The
+ *                function ignores `NULL`.
+ */
+void ckdb::yawnOptionsDel(YawnOptions *options) { delete options; }
+
+/**
+ * @brief This function specifies if the converter drops comments.
+ *
+ * @param options This argument stores the settings this function changes.
+ * @param skipComments This value specifies if the converter should drop
+ *                     comments (non-zero) or not (`0`).
+ */
+void ckdb::yawnOptionsSetSkipComments(YawnOptions *options, int skipComments) {
+  options->options.skipComments = skipComments != 0;
+}
+
+/**
+ * @brief This function sets the directory of the grammar files.
+ *
+ * @param options This argument stores the settings this function changes.
+ * @param directory This text stores the path of the directory that contains
+ *                  the grammar files of the converter.
+ *
+ * @retval -1 if there was not enough memory to store the path
+ * @retval  0 otherwise
+ */
+int ckdb::yawnOptionsSetGrammarDirectory(YawnOptions *options,
+                                         char const *directory) {
+  try {
+    options->options.grammarDirectory = directory;
+  } catch (...) {
+    return -1;
+  }
+  return 0;
+}
+
+/**
+ * @brief This function sets the number of threads the converter uses.
+ *
+ * @param options This argument stores the settings this function changes.
+ * @param threads This number specifies the number of threads. The converter
+ *                uses one thread per processor core, if the value is `0`.
+ */
+void ckdb::yawnOptionsSetThreads(YawnOptions *options, size_t threads) {
+  options->options.threads = threads;
+}
+
+/**
+ * @brief This function specifies if the lexer runs in a separate thread.
+ *
+ * @param options This argument stores the settings this function changes.
+ * @param pipeline This value specifies if the lexer should run in its own
+ *                 thread (non-zero) or not (`0`).
+ */
+void ckdb::yawnOptionsSetPipeline(YawnOptions *options, int pipeline) {
+  options->options.pipeline = pipeline != 0;
+}
+
+/**
+ * @brief This function sets a resource limit of the converter.
+ *
+ * @param options This argument stores the settings this function changes.
+ * @param limit This value specifies the limit this function changes.
+ * @param value This number specifies the new value of the limit. The value
+ *              `0` disables the limit.
+ *
+ * @retval -1 if `limit` is not a valid limit
+ * @retval  0 otherwise
+ */
+int ckdb::yawnOptionsSetLimit(YawnOptions *options, YawnLimit limit,
+                              size_t value) {
+  switch (limit) {
+  case ckdb::YAWN_MAX_BYTES:
+    options->options.maxBytes = value;
+    return 0;
+  case ckdb::YAWN_MAX_DEPTH:
+    options->options.maxDepth = value;
+    return 0;
+  case ckdb::YAWN_MAX_SCALAR_LENGTH:
+    options->options.maxScalarLength = value;
+    return 0;
+  case ckdb::YAWN_MAX_TOKENS:
+    options->options.maxTokens = value;
+    return 0;
+  case ckdb::YAWN_MAX_KEYS:
+    options->options.maxKeys = value;
+    return 0;
+  }
+  return -1;
+}
+
+/**
+ * @brief This function sets the maximum time a single conversion may take.
+ *
+ * @param options This argument stores the settings this function changes.
+ * @param timeout This number specifies the maximum duration of each
+ *                conversion that uses `options` in milliseconds. The value
+ *                `0` disables the timeout.
+ */
+void ckdb::yawnOptionsSetTimeout(YawnOptions *options,
+                                 unsigned long timeout) {
+  options->timeout = milliseconds(timeout);
+}
+
+/**
+ * @brief This function converts the given YAML file to keys and adds the
+ *        result to `keySet`.
+ *
+ * If the conversion fails, then the function stores a description of the
+ * error in the metadata `error/reason` of `parentKey`.
+ *
+ * @param keySet The function adds the converted keys to this key set.
+ * @param parentKey The function stores the converted keys below this key.
+ * @param filename This text stores the path of the YAML file this function
+ *                 converts.
+ * @param options This argument stores the settings of the converter. If it
+ *                is `NULL`, then the function uses the default settings.
+ *
+ * @retval -3 if the conversion exceeded the timeout
+ * @retval -2 if the file could not be opened for reading
+ * @retval -1 if there was a error converting the YAML file
+ * @retval  0 if parsing was successful and the function did not change the
+ *            given keyset
+ * @retval  1 if parsing was successful and the function did change `keySet`
+ */
+int ckdb::yawnAddFile(KeySet *keySet, Key *parentKey, char const *filename,
+                      YawnOptions const *options) {
+  if (!filename) {
+    return -2;
+  }
+  return run(keySet, parentKey, options,
+             [filename](kdb::KeySet &keys, kdb::Key &parent,
+                        Options const &settings) {
+               return addToKeySet(keys, parent, filename, settings);
+             });
+}
+
+/**
+ * @brief This function converts YAML data stored in memory to keys and adds
+ *        the result to `keySet`.
+ *
+ * If the conversion fails, then the function stores a description of the
+ * error in the metadata `error/reason` of `parentKey`.
+ *
+ * @param keySet The function adds the converted keys to this key set.
+ * @param parentKey The function stores the converted keys below this key.
+ * @param buffer This argument points to the YAML data this function
+ *               converts. The data does not need to end with a null byte.
+ * @param size This number specifies the size of `buffer` in bytes.
+ * @param options This argument stores the settings of the converter. If it
+ *                is `NULL`, then the function uses the default settings.
+ *
+ * @retval -3 if the conversion exceeded the timeout
+ * @retval -1 if there was a error converting the YAML data
+ * @retval  0 if parsing was successful and the function did not change the
+ *            given keyset
+ * @retval  1 if parsing was successful and the function did change `keySet`
+ */
+int ckdb::yawnAddBuffer(KeySet *keySet, Key *parentKey, char const *buffer,
+                        size_t size, YawnOptions const *options) {
+  if (!buffer && size > 0) {
+    return -1;
+  }
+  return run(keySet, parentKey, options,
+             [buffer, size](kdb::KeySet &keys, kdb::Key &parent,
+                            Options const &settings) {
+               return addBufferToKeySet(keys, parent,
+                                        string{buffer, buffer + size},
+                                        settings);
+             });
+}
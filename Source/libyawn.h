@@ -0,0 +1,207 @@
+/**
+ * @file
+ *
+ * @brief This file contains the C interface of the YAML to `KeySet`
+ *        converter library.
+ *
+ * The interface only uses C types, so programs written in C (or any language
+ * with a C foreign function interface) can link against the library instead
+ * of starting the `yawn` executable for every conversion.
+ *
+ * @copyright BSD License (see LICENSE.md or https://www.libelektra.org)
+ */
+
+#ifndef ELEKTRA_PLUGIN_YAWN_LIBYAWN_H
+#define ELEKTRA_PLUGIN_YAWN_LIBYAWN_H
+
+// -- Imports ------------------------------------------------------------------
+
+#include <stddef.h>
+
+#include <kdb.h>
+
+// -- Macros -------------------------------------------------------------------
+
+/**
+ * This number specifies the version of the interface. We only increase it,
+ * if we change the signature or the behavior of an existing function.
+ */
+#define YAWN_API_VERSION 1
+
+#ifdef __cplusplus
+namespace ckdb {
+extern "C" {
+#endif
+
+// -- Types --------------------------------------------------------------------
+
+/** This type stores the settings of the converter. */
+typedef struct _YawnOptions YawnOptions;
+
+/** This enumeration specifies the resource limits of the converter. */
+typedef enum {
+  /** The maximum size of the input in bytes */
+  YAWN_MAX_BYTES,
+  /** The maximum number of nested block collections */
+  YAWN_MAX_DEPTH,
+  /** The maximum length of a scalar in bytes */
+  YAWN_MAX_SCALAR_LENGTH,
+  /** The maximum number of tokens of the input */
+  YAWN_MAX_TOKENS,
+  /** The maximum number of keys the converter adds */
+  YAWN_MAX_KEYS
+} YawnLimit;
+
+// -- Functions ----------------------------------------------------------------
+
+/**
+ * @brief This function returns the version of the interface implemented by
+ *        the linked library.
+ *
+ * @return The value of `YAWN_API_VERSION` the library was compiled with
+ */
+int yawnVersion(void);
+
+/**
+ * @brief This function creates settings with the default values of the
+ *        converter.
+ *
+ * @return New settings the caller has to free with `yawnOptionsDel`, or
+ *         `NULL` if there was not enough memory
+ */
+YawnOptions *yawnOptionsNew(void);
+
+/**
+ * @brief This function creates settings that convert well formed input as
+ *        fast as possible.
+ *
+ * @return New settings the caller has to free with `yawnOptionsDel`, or
+ *         `NULL` if there was not enough memory
+ */
+YawnOptions *yawnOptionsNewProduction(void);
+
+/**
+ * @brief This function frees the given settings.
+ *
+ * @param options This argument stores the settings this function frees. The
+ *                function ignores `NULL`.
+ */
+void yawnOptionsDel(YawnOptions *options);
+
+/**
+ * @brief This function specifies if the converter drops comments.
+ *
+ * @param options This argument stores the settings this function changes.
+ * @param skipComments This value specifies if the converter should drop
+ *                     comments (non-zero) or not (`0`).
+ */
+void yawnOptionsSetSkipComments(YawnOptions *options, int skipComments);
+
+/**
+ * @brief This function sets the directory of the grammar files.
+ *
+ * @param options This argument stores the settings this function changes.
+ * @param directory This text stores the path of the directory that contains
+ *                  the grammar files of the converter.
+ *
+ * @retval -1 if there was not enough memory to store the path
+ * @retval  0 otherwise
+ */
+int yawnOptionsSetGrammarDirectory(YawnOptions *options,
+                                   char const *directory);
+
+/**
+ * @brief This function sets the number of threads the converter uses.
+ *
+ * @param options This argument stores the settings this function changes.
+ * @param threads This number specifies the number of threads. The converter
+ *                uses one thread per processor core, if the value is `0`.
+ */
+void yawnOptionsSetThreads(YawnOptions *options, size_t threads);
+
+/**
+ * @brief This function specifies if the lexer runs in a separate thread.
+ *
+ * @param options This argument stores the settings this function changes.
+ * @param pipeline This value specifies if the lexer should run in its own
+ *                 thread (non-zero) or not (`0`).
+ */
+void yawnOptionsSetPipeline(YawnOptions *options, int pipeline);
+
+/**
+ * @brief This function sets a resource limit of the converter.
+ *
+ * @param options This argument stores the settings this function changes.
+ * @param limit This value specifies the limit this function changes.
+ * @param value This number specifies the new value of the limit. The value
+ *              `0` disables the limit.
+ *
+ * @retval -1 if `limit` is not a valid limit
+ * @retval  0 otherwise
+ */
+int yawnOptionsSetLimit(YawnOptions *options, YawnLimit limit, size_t value);
+
+/**
+ * @brief This function sets the maximum time a single conversion may take.
+ *
+ * @param options This argument stores the settings this function changes.
+ * @param timeout This number specifies the maximum duration of each
+ *                conversion that uses `options` in milliseconds. The value
+ *                `0` disables the timeout.
+ */
+void yawnOptionsSetTimeout(YawnOptions *options, unsigned long timeout);
+
+/**
+ * @brief This function converts the given YAML file to keys and adds the
+ *        result to `keySet`.
+ *
+ * If the conversion fails, then the function stores a description of the
+ * error in the metadata `error/reason` of `parentKey`.
+ *
+ * @param keySet The function adds the converted keys to this key set.
+ * @param parentKey The function stores the converted keys below this key.
+ * @param filename This text stores the path of the YAML file this function
+ *                 converts.
+ * @param options This argument stores the settings of the converter. If it
+ *                is `NULL`, then the function uses the default settings.
+ *
+ * @retval -3 if the conversion exceeded the timeout
+ * @retval -2 if the file could not be opened for reading
+ * @retval -1 if there was a error converting the YAML file
+ * @retval  0 if parsing was successful and the function did not change the
+ *            given keyset
+ * @retval  1 if parsing was successful and the function did change `keySet`
+ */
+int yawnAddFile(KeySet *keySet, Key *parentKey, char const *filename,
+                YawnOptions const *options);
+
+/**
+ * @brief This function converts YAML data stored in memory to keys and adds
+ *        the result to `keySet`.
+ *
+ * If the conversion fails, then the function stores a description of the
+ * error in the metadata `error/reason` of `parentKey`.
+ *
+ * @param keySet The function adds the converted keys to this key set.
+ * @param parentKey The function stores the converted keys below this key.
+ * @param buffer This argument points to the YAML data this function
+ *               converts. The data does not need to end with a null byte.
+ * @param size This number specifies the size of `buffer` in bytes.
+ * @param options This argument stores the settings of the converter. If it
+ *                is `NULL`, then the function uses the default settings.
+ *
+ * @retval -3 if the conversion exceeded the timeout
+ * @retval -1 if there was a error converting the YAML data
+ * @retval  0 if parsing was successful and the function did not change the
+ *            given keyset
+ * @retval  1 if parsing was successful and the function did change `keySet`
+ */
+int yawnAddBuffer(KeySet *keySet, Key *parentKey, char const *buffer,
+                  size_t size, YawnOptions const *options);
+
+#ifdef __cplusplus
+}
+}
+#endif
+
+#endif // ELEKTRA_PLUGIN_YAWN_LIBYAWN_H
@@ -8,10 +8,16 @@
 
 // -- Imports ------------------------------------------------------------------
 
+#include <cstdint>
+#include <cstring>
+#include <limits>
 #include <stdexcept>
 
 #include "listener.hpp"
 
+using std::length_error;
+using std::move;
+using std::numeric_limits;
 using std::overflow_error;
 using std::string;
 using std::to_string;
@@ -23,61 +29,529 @@ using kdb::Key;
 namespace {
 
 /**
- * @brief This function converts a given number to an array base name.
+ * @brief This function checks if a character is a space or a tab.
  *
- * @param index This number specifies the index of the array entry.
+ * @param character This argument stores the character this function checks.
  *
- * @return A string representing the given indices as Elektra array name.
+ * @retval true If `character` is a space or a tab
+ * @retval false Otherwise
  */
-string indexToArrayBaseName(uintmax_t const index) {
-  size_t digits = 1;
+inline bool isWhite(char const character) {
+  return character == ' ' || character == '\t';
+}
 
-  for (uintmax_t value = index; value > 9; digits++) {
-    value /= 10;
+/**
+ * @brief This function skips the line breaks and indentation that follow a
+ *        line break inside a quoted scalar.
+ *
+ * @param text This argument points to the content of the scalar.
+ * @param size This number specifies the length of `text` in bytes.
+ * @param offset This number specifies the offset of the line break. The
+ *               function stores the offset of the next content character in
+ *               this variable.
+ *
+ * @return The number of empty lines that follow the first line break
+ */
+size_t skipLineBreaks(char const *text, size_t const size, size_t &offset) {
+  size_t empty = 0;
+  offset++;
+  while (true) {
+    while (offset < size && (isWhite(text[offset]) || text[offset] == '\r')) {
+      offset++;
+    }
+    if (offset >= size || text[offset] != '\n') {
+      return empty;
+    }
+    empty++;
+    offset++;
   }
+}
 
-  return "#" + string(digits - 1, '_') + to_string(index);
+/**
+ * @brief This function folds a line break inside a quoted scalar.
+ *
+ * The function replaces the line break by a single space, or by one newline
+ * character for each empty line that follows it.
+ *
+ * @param text This argument points to the content of the scalar.
+ * @param size This number specifies the length of `text` in bytes.
+ * @param offset This number specifies the offset of the line break. The
+ *               function stores the offset of the next content character in
+ *               this variable.
+ * @param value The function adds the folded text to this variable.
+ * @param kept This number specifies the length of `value` that the function
+ *             must not change, since it contains escaped characters.
+ */
+void foldLine(char const *text, size_t const size, size_t &offset,
+              string &value, size_t const kept) {
+  // Trailing white space of a line is not part of the value
+  size_t end = value.size();
+  while (end > kept && (isWhite(value[end - 1]) || value[end - 1] == '\r')) {
+    end--;
+  }
+  value.resize(end);
+  size_t const empty = skipLineBreaks(text, size, offset);
+  value.append(empty == 0 ? 1 : empty, empty == 0 ? ' ' : '\n');
 }
 
 /**
- * @brief This function converts a YAML scalar to a string.
+ * @brief This function adds the UTF-8 encoding of a code point to a string.
  *
- * @param text This string contains a YAML scalar (including quote
- *             characters).
+ * @param codePoint This number specifies the code point this function
+ *                  encodes.
+ * @param value The function adds the encoded code point to this variable.
  *
- * @return A string without leading and trailing quote characters
+ * @retval true If `codePoint` is a valid Unicode scalar value
+ * @retval false Otherwise
  */
-string scalarToText(string const &text) {
-  if (text.length() == 0) {
-    return text;
+bool appendUtf8(uint32_t const codePoint, string &value) {
+  if (codePoint > 0x10FFFF || (codePoint >= 0xD800 && codePoint <= 0xDFFF)) {
+    return false;
   }
-  if (*(text.begin()) == '"' || *(text.begin()) == '\'') {
-    return text.substr(1, text.length() - 2);
+  if (codePoint < 0x80) {
+    value += static_cast<char>(codePoint);
+  } else if (codePoint < 0x800) {
+    value += static_cast<char>(0xC0 | codePoint >> 6);
+    value += static_cast<char>(0x80 | (codePoint & 0x3F));
+  } else if (codePoint < 0x10000) {
+    value += static_cast<char>(0xE0 | codePoint >> 12);
+    value += static_cast<char>(0x80 | (codePoint >> 6 & 0x3F));
+    value += static_cast<char>(0x80 | (codePoint & 0x3F));
+  } else {
+    value += static_cast<char>(0xF0 | codePoint >> 18);
+    value += static_cast<char>(0x80 | (codePoint >> 12 & 0x3F));
+    value += static_cast<char>(0x80 | (codePoint >> 6 & 0x3F));
+    value += static_cast<char>(0x80 | (codePoint & 0x3F));
   }
-  return text;
+  return true;
+}
+
+/**
+ * @brief This function reads a hexadecimal number of a fixed length.
+ *
+ * @param text This argument points to the first digit of the number.
+ * @param digits This number specifies the number of digits.
+ * @param number The function stores the value of the number in this
+ *               variable.
+ *
+ * @retval true If `text` starts with `digits` hexadecimal digits
+ * @retval false Otherwise
+ */
+bool readHexadecimal(char const *text, size_t const digits, uint32_t &number) {
+  number = 0;
+  for (size_t index = 0; index < digits; index++) {
+    char const digit = text[index];
+    number <<= 4;
+    if (digit >= '0' && digit <= '9') {
+      number |= static_cast<uint32_t>(digit - '0');
+    } else if (digit >= 'a' && digit <= 'f') {
+      number |= static_cast<uint32_t>(digit - 'a' + 10);
+    } else if (digit >= 'A' && digit <= 'F') {
+      number |= static_cast<uint32_t>(digit - 'A' + 10);
+    } else {
+      return false;
+    }
+  }
+  return true;
+}
+
+/**
+ * @brief This function decodes an escape sequence of a double quoted scalar.
+ *
+ * @param text This argument points to the content of the scalar.
+ * @param size This number specifies the length of `text` in bytes.
+ * @param offset This number specifies the offset of the backslash that
+ *               starts the escape sequence. The function stores the offset
+ *               after the escape sequence in this variable.
+ * @param value The function adds the decoded text to this variable.
+ */
+void decodeEscape(char const *text, size_t const size, size_t &offset,
+                  string &value) {
+  if (offset + 1 >= size) {
+    value += text[offset++];
+    return;
+  }
+
+  char const escaped = text[offset + 1];
+  char const *replacement = nullptr;
+  size_t digits = 0;
+  switch (escaped) {
+  case '0':
+    value += '\0';
+    break;
+  case 'a':
+    replacement = "\a";
+    break;
+  case 'b':
+    replacement = "\b";
+    break;
+  case 't':
+  case '\t':
+    replacement = "\t";
+    break;
+  case 'n':
+    replacement = "\n";
+    break;
+  case 'v':
+    replacement = "\v";
+    break;
+  case 'f':
+    replacement = "\f";
+    break;
+  case 'r':
+    replacement = "\r";
+    break;
+  case 'e':
+    replacement = "\x1B";
+    break;
+  case ' ':
+  case '"':
+  case '/':
+  case '\\':
+    value += escaped;
+    break;
+  case 'N':
+    replacement = "\xC2\x85";
+    break;
+  case '_':
+    replacement = "\xC2\xA0";
+    break;
+  case 'L':
+    replacement = "\xE2\x80\xA8";
+    break;
+  case 'P':
+    replacement = "\xE2\x80\xA9";
+    break;
+  case 'x':
+    digits = 2;
+    break;
+  case 'u':
+    digits = 4;
+    break;
+  case 'U':
+    digits = 8;
+    break;
+  case '\r':
+  case '\n': {
+    // An escaped line break joins the lines without adding a space
+    offset++;
+    value.append(skipLineBreaks(text, size, offset), '\n');
+    return;
+  }
+  default:
+    // Keep unknown escape sequences unchanged
+    value.append(text + offset, 2);
+  }
+
+  if (replacement) {
+    value += replacement;
+  }
+  uint32_t codePoint;
+  if (digits > 0 &&
+      (offset + 2 + digits > size ||
+       !readHexadecimal(text + offset + 2, digits, codePoint) ||
+       !appendUtf8(codePoint, value))) {
+    // Keep invalid escape sequences unchanged
+    value.append(text + offset, 2);
+    digits = 0;
+  }
+  offset += 2 + digits;
+}
+
+/**
+ * @brief This function returns the value of a double quoted scalar.
+ *
+ * @param text This argument points to the content of the scalar without
+ *             quotes.
+ * @param size This number specifies the length of `text` in bytes.
+ *
+ * @return The value of the scalar
+ */
+string decodeDoubleQuoted(char const *text, size_t const size) {
+  string value;
+  value.reserve(size);
+  size_t kept = 0;
+  size_t offset = 0;
+  while (offset < size) {
+    // Copy text without escapes and line breaks in one block
+    size_t end = offset;
+    while (end < size && text[end] != '\\' && text[end] != '\n') {
+      end++;
+    }
+    value.append(text + offset, end - offset);
+    offset = end;
+    if (offset >= size) {
+      break;
+    }
+    if (text[offset] == '\\') {
+      decodeEscape(text, size, offset, value);
+      kept = value.size();
+    } else {
+      foldLine(text, size, offset, value, kept);
+    }
+  }
+  return value;
+}
+
+/**
+ * @brief This function returns the value of a single quoted scalar.
+ *
+ * @param text This argument points to the content of the scalar without
+ *             quotes.
+ * @param size This number specifies the length of `text` in bytes.
+ *
+ * @return The value of the scalar
+ */
+string decodeSingleQuoted(char const *text, size_t const size) {
+  string value;
+  value.reserve(size);
+  size_t kept = 0;
+  size_t offset = 0;
+  while (offset < size) {
+    size_t end = offset;
+    while (end < size && text[end] != '\'' && text[end] != '\n') {
+      end++;
+    }
+    value.append(text + offset, end - offset);
+    offset = end;
+    if (offset >= size) {
+      break;
+    }
+    if (text[offset] == '\'') {
+      // The lexer only accepts single quotes inside the scalar as `''`
+      value += '\'';
+      offset += 2;
+      kept = value.size();
+    } else {
+      foldLine(text, size, offset, value, kept);
+    }
+  }
+  return value;
+}
+
+/**
+ * @brief This function reads the header the lexer stores in front of the
+ *        content of a block scalar.
+ *
+ * The header contains the style (`|` or `>`), the chomping indicator (`-`,
+ * `+` or a space for clipping) and the indentation of the content, followed
+ * by a newline character.
+ *
+ * @param text This argument stores the block scalar.
+ * @param indentation The function stores the indentation of the content in
+ *                    this variable.
+ * @param offset The function stores the offset of the content in this
+ *               variable.
+ *
+ * @retval true If `text` starts with the header of a block scalar
+ * @retval false Otherwise
+ */
+bool readBlockHeader(string const &text, size_t &indentation,
+                     size_t &offset) {
+  if (text.size() < 4 || (text[0] != '|' && text[0] != '>') ||
+      (text[1] != ' ' && text[1] != '-' && text[1] != '+')) {
+    return false;
+  }
+  indentation = 0;
+  offset = 2;
+  // The lexer stores the indentation as 16 bit number with at most 5 digits
+  while (offset < 7 && offset < text.size() && text[offset] >= '0' &&
+         text[offset] <= '9') {
+    indentation = indentation * 10 + static_cast<size_t>(text[offset] - '0');
+    offset++;
+  }
+  if (offset == 2 || offset >= text.size() || text[offset] != '\n') {
+    return false;
+  }
+  offset++;
+  return true;
+}
+
+/**
+ * @brief This function replaces a block scalar by its value.
+ *
+ * The function removes the indentation of every line, folds the lines of a
+ * folded scalar and applies the chomping indicator. The value is never
+ * longer than the scalar. The function therefore moves the content of each
+ * line to its final location inside `text` instead of allocating a new
+ * string.
+ *
+ * @param text This argument stores the block scalar including the header
+ *             read by `readBlockHeader`. The function replaces it with the
+ *             value of the scalar.
+ * @param indentation This number specifies the indentation of the content.
+ * @param offset This number specifies the offset of the content.
+ */
+void decodeBlockScalar(string &text, size_t const indentation,
+                       size_t offset) {
+  bool const folded = text[0] == '>';
+  char const chomping = text[1];
+  char *const data = &text[0];
+  size_t const size = text.size();
+  size_t written = 0;
+  size_t breaks = 0;
+  bool content = false;
+  bool spaced = false;
+
+  while (offset < size) {
+    auto const newline =
+        static_cast<char *>(memchr(data + offset, '\n', size - offset));
+    size_t const end =
+        newline == nullptr ? size : static_cast<size_t>(newline - data);
+    size_t line = offset;
+    while (line < end && line - offset < indentation && data[line] == ' ') {
+      line++;
+    }
+    offset = end + 1;
+    if (line == end) {
+      breaks += end < size ? 1 : 0; // Empty line
+      continue;
+    }
+
+    // Folding only replaces line breaks between lines that are not indented
+    // more than the content
+    bool const more = isWhite(data[line]);
+    bool const fold = folded && content && !spaced && !more;
+    if (fold && breaks == 1) {
+      data[written++] = ' ';
+    } else {
+      size_t const feeds = fold ? breaks - 1 : breaks;
+      memset(data + written, '\n', feeds);
+      written += feeds;
+    }
+    memmove(data + written, data + line, end - line);
+    written += end - line;
+    content = true;
+    spaced = more;
+    breaks = end < size ? 1 : 0;
+  }
+
+  if (chomping == '+') {
+    memset(data + written, '\n', breaks);
+    written += breaks;
+  } else if (chomping == ' ' && content && breaks > 0) {
+    data[written++] = '\n';
+  }
+  text.resize(written);
 }
 
 } // namespace
 
+/**
+ * @brief This function appends the Elektra array base name of a given number
+ *        to a string.
+ *
+ * @param text This argument stores the string this function extends.
+ * @param index This number specifies the index of the array entry.
+ */
+void appendArrayBaseName(string &text, uintmax_t index) {
+  char digits[numeric_limits<uintmax_t>::digits10 + 1];
+  size_t length = 0;
+
+  do {
+    digits[length++] = static_cast<char>('0' + index % 10);
+    index /= 10;
+  } while (index > 0);
+
+  text += '#';
+  text.append(length - 1, '_');
+  while (length > 0) {
+    text += digits[--length];
+  }
+}
+
+/**
+ * @brief This function converts a YAML scalar to a string.
+ *
+ * The function removes the quote characters of quoted scalars, decodes
+ * escape sequences and folds line breaks. Quoted scalars without escape
+ * sequences and line breaks only lose their quote characters. For block
+ * scalars the function removes the indentation, folds lines and applies the
+ * chomping indicator.
+ *
+ * @param text This string contains a YAML scalar (including quote
+ *             characters or the header of a block scalar).
+ *
+ * @return A string that contains the value of the given scalar
+ */
+string scalarToText(string text) {
+  decodeScalar(text);
+  return text;
+}
+
+/**
+ * @brief This function converts a YAML scalar to its value in place.
+ *
+ * @param text This string contains a YAML scalar (including quote
+ *             characters or the header of a block scalar). The function
+ *             replaces it with the value of the scalar.
+ */
+void decodeScalar(string &text) {
+  size_t indentation;
+  size_t offset;
+  if (readBlockHeader(text, indentation, offset)) {
+    decodeBlockScalar(text, indentation, offset);
+    return;
+  }
+
+  if (text.size() < 2 || (text.front() != '"' && text.front() != '\'') ||
+      text.back() != text.front()) {
+    return;
+  }
+
+  char const quote = text.front();
+  char const *const content = text.data() + 1;
+  size_t const size = text.size() - 2;
+  // Most quoted scalars contain neither escapes nor line breaks. In this case
+  // we only need to remove the quotes, which does not allocate memory.
+  if (!memchr(content, quote == '"' ? '\\' : '\'', size) &&
+      !memchr(content, '\n', size)) {
+    text.pop_back();
+    text.erase(0, 1);
+    return;
+  }
+
+  text = quote == '"' ? decodeDoubleQuoted(content, size)
+                      : decodeSingleQuoted(content, size);
+}
+
 // -- Class --------------------------------------------------------------------
 
+/**
+ * @brief This method adds a key to the key set of this listener.
+ *
+ * @param key This argument specifies the key this method adds.
+ */
+void Listener::append(Key const &key) {
+  keys.append(key);
+  if (maxKeys > 0 && static_cast<size_t>(keys.size()) > maxKeys) {
+    throw length_error("Input exceeds the maximum number of " +
+                       to_string(maxKeys) + " keys");
+  }
+}
+
 /**
  * @brief This constructor creates a Listener using the given parent key.
  *
  * @param parent This argument specifies the parent key of the key set this
  *               listener produces.
+ * @param limit This number specifies the maximum number of keys the
+ *              listener creates. If the walker produces more keys, then the
+ *              listener throws a `length_error`.
  */
-Listener::Listener(Key const &parent) { parents.push(parent); }
+Listener::Listener(Key const &parent, size_t const limit) : maxKeys{limit} {
+  parents.push(parent);
+}
 
 /**
  * @brief This function will be called after the walker exits a value node.
  *
  * @param text This variable contains the text stored in the value.
  */
-void Listener::exitValue(string const &text) {
+void Listener::exitValue(string text) {
   Key key = parents.top();
-  key.setString(scalarToText(text));
-  keys.append(key);
+  key.setString(scalarToText(move(text)));
+  append(key);
 }
 
 /**
@@ -85,11 +559,11 @@ void Listener::exitValue(string const &text) {
  *
  * @param text This variable contains the text of the key.
  */
-void Listener::exitKey(string const &text) {
+void Listener::exitKey(string text) {
   // Entering a mapping such as `part: …` means that we need to add `part` to
   // the key name
   Key child{parents.top().getName(), KEY_END};
-  child.addBaseName(scalarToText(text));
+  child.addBaseName(scalarToText(move(text)));
   parents.push(child);
 }
 
@@ -103,7 +577,7 @@ void Listener::exitKey(string const &text) {
 void Listener::exitPair(bool const matchedValue) {
   if (!matchedValue) {
     // Add key with empty value
-    keys.append(parents.top());
+    append(parents.top());
   }
   // Returning from a mapping such as `part: …` means that we need need to
   // remove the key for `part` from the stack.
@@ -115,17 +589,28 @@ void Listener::exitPair(bool const matchedValue) {
  *        node.
  */
 void Listener::enterSequence() {
-  indices.push(0);
-  parents.top().setMeta("array", ""); // We start with an empty array
+  string prefix = parents.top().getName();
+  if (prefix.empty() || prefix.back() != '/') {
+    prefix += '/';
+  }
+  sequences.push(Sequence{prefix, 0});
 }
 
 /**
  * @brief This function will be called after the walker exits a sequence node.
  */
 void Listener::exitSequence() {
+  // We store the base name of the last element in the `array` metadata of
+  // the parent once, instead of updating it for every element
+  string last;
+  if (sequences.top().index > 0) {
+    appendArrayBaseName(last, sequences.top().index - 1);
+  }
+  parents.top().setMeta("array", last);
+
   // We add the parent key of all array elements after we leave the sequence
-  keys.append(parents.top());
-  indices.pop();
+  append(parents.top());
+  sequences.pop();
 }
 
 /**
@@ -133,20 +618,16 @@ void Listener::exitSequence() {
  *        node.
  */
 void Listener::enterElement() {
-  Key key{parents.top().getName(), KEY_END};
-  if (indices.top() >= UINTMAX_MAX)
+  Sequence &sequence = sequences.top();
+  if (sequence.index >= UINTMAX_MAX)
     throw overflow_error("Unable to increase array index for array “" +
-                         key.getName() + "”");
-
-  key.addBaseName(indexToArrayBaseName(indices.top()));
-
-  uintmax_t index = indices.top();
-  indices.pop();
-  index++;
-  indices.push(index);
+                         parents.top().getName() + "”");
 
-  parents.top().setMeta("array", key.getBaseName());
-  parents.push(key);
+  // The prefix already is a valid key name, so we can add the base name of
+  // the element without escaping it
+  name.assign(sequence.prefix);
+  appendArrayBaseName(name, sequence.index++);
+  parents.push(Key{name, KEY_END});
 }
 
 /**
@@ -19,13 +19,50 @@
 
 using std::string;
 
+// -- Functions ----------------------------------------------------------------
+
+/**
+ * @brief This function converts a YAML scalar to a string.
+ *
+ * The function removes the quote characters of quoted scalars, decodes
+ * escape sequences and folds line breaks. Quoted scalars without escape
+ * sequences and line breaks only lose their quote characters. For block
+ * scalars the function removes the indentation, folds lines and applies the
+ * chomping indicator.
+ *
+ * @param text This string contains a YAML scalar (including quote
+ *             characters or the header of a block scalar).
+ *
+ * @return A string that contains the value of the given scalar
+ */
+std::string scalarToText(std::string text);
+
+/**
+ * @brief This function converts a YAML scalar to its value in place.
+ *
+ * @param text This string contains a YAML scalar (including quote
+ *             characters or the header of a block scalar). The function
+ *             replaces it with the value of the scalar.
+ */
+void decodeScalar(std::string &text);
+
+/**
+ * @brief This function appends the Elektra array base name of a given number
+ *        to a string.
+ *
+ * @param text This argument stores the string this function extends.
+ * @param index This number specifies the index of the array entry.
+ */
+void appendArrayBaseName(std::string &text, uintmax_t index);
+
 // -- Class --------------------------------------------------------------------
 
 /**
  * @brief This class contains methods to create a key set.
  *
- * The tree walker (`walker`) calls the various methods of this class to create
- * a key set from the syntax tree created by the parser (`convert`).
+ * The tree walker (`walk`) calls the various methods of this class to create
+ * a key set from the syntax tree created by the parser (`convert`). The class
+ * implements the static sink interface described in `walk.hpp`.
  */
 class Listener {
   /** This variable stores the key set that this listener creates. */
@@ -37,10 +74,42 @@ class Listener {
    */
   std::stack<kdb::Key> parents;
 
+  /** This structure stores the state of a sequence the walker visits. */
+  struct Sequence {
+    /**
+     * This variable stores the name of the key of the sequence followed by a
+     * slash.
+     */
+    std::string prefix;
+
+    /** This number specifies the index of the next array element. */
+    uintmax_t index;
+  };
+
   /**
-   * This stack stores indices for the next array elements.
+   * This stack stores the state of each sequence that contains the current
+   * node.
+   */
+  std::stack<Sequence> sequences;
+
+  /**
+   * This variable stores the name of the last array element. The listener
+   * reuses it for all elements to avoid allocations.
+   */
+  std::string name;
+
+  /**
+   * This number specifies the maximum number of keys the listener creates.
+   * The value `0` disables this limit.
+   */
+  size_t maxKeys;
+
+  /**
+   * @brief This method adds a key to the key set of this listener.
+   *
+   * @param key This argument specifies the key this method adds.
    */
-  std::stack<uintmax_t> indices;
+  void append(kdb::Key const &key);
 
 public:
   /**
@@ -48,22 +117,25 @@ public:
    *
    * @param parent This argument specifies the parent key of the key set this
    *               listener produces.
+   * @param limit This number specifies the maximum number of keys the
+   *              listener creates. If the walker produces more keys, then the
+   *              listener throws a `length_error`.
    */
-  Listener(kdb::Key const &parent);
+  Listener(kdb::Key const &parent, size_t const limit = 0);
 
   /**
    * @brief This function will be called after the walker exits a value node.
    *
    * @param text This variable contains the text stored in the value.
    */
-  void exitValue(std::string const &text);
+  void exitValue(std::string text);
 
   /**
    * @brief This function will be called after the walker exits a key node.
    *
    * @param text This variable contains the text of the key.
    */
-  void exitKey(string const &text);
+  void exitKey(std::string text);
 
   /**
    * @brief This function will be called after the walker exits the node for a
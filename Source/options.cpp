@@ -0,0 +1,30 @@
+/**
+ * @file
+ *
+ * @brief This file contains the implementation of a class that stores
+ *        settings for the YAML to `KeySet` converter.
+ *
+ * @copyright BSD License (see LICENSE.md or https://www.libelektra.org)
+ */
+
+// -- Imports ------------------------------------------------------------------
+
+#include "options.hpp"
+
+// -- Class --------------------------------------------------------------------
+
+/**
+ * @brief This function returns settings that convert well formed input as
+ *        fast as possible.
+ *
+ * The returned settings disable error recovery and the check for ambiguous
+ * syntax trees, since the grammar of the converter is unambiguous.
+ *
+ * @return Settings for the conversion of machine generated input
+ */
+Options Options::production() {
+  Options options;
+  options.errorRecovery = false;
+  options.checkAmbiguity = false;
+  return options;
+}
@@ -0,0 +1,164 @@
+/**
+ * @file
+ *
+ * @brief This file contains a class that stores settings for the YAML to
+ *        `KeySet` converter.
+ *
+ * @copyright BSD License (see LICENSE.md or https://www.libelektra.org)
+ */
+
+#ifndef ELEKTRA_PLUGIN_YAWN_OPTIONS_HPP
+#define ELEKTRA_PLUGIN_YAWN_OPTIONS_HPP
+
+// -- Imports ------------------------------------------------------------------
+
+#include <string>
+
+#include "cancellation.hpp"
+#include "hash.hpp"
+#include "statistics.hpp"
+
+// -- Class --------------------------------------------------------------------
+
+/** This class stores settings that change how the converter reads YAML. */
+class Options {
+public:
+  /**
+   * This variable specifies if the lexer should drop comments while scanning
+   * the input instead of emitting them as tokens. The converter then also uses
+   * a grammar that does not contain any rules for comments.
+   */
+  bool skipComments = false;
+
+  /**
+   * This variable stores the directory that contains the grammar files of the
+   * converter. A relative path refers to the current working directory.
+   */
+  std::string grammarDirectory = "Grammar";
+
+  /**
+   * This variable specifies if the converter should print the syntax tree of
+   * the input to the standard output.
+   */
+  bool printSyntaxTree = false;
+
+  /**
+   * If this variable is not `nullptr`, then the converter adds timing
+   * information and counters for each of its stages to the pointed to
+   * object.
+   */
+  Statistics *statistics = nullptr;
+
+  /**
+   * This number specifies how many tokens YAEP looks ahead (`0`, `1` or `2`)
+   * to reduce the number of parser states it creates.
+   */
+  int lookaheadLevel = 1;
+
+  /**
+   * This variable specifies if YAEP should only build a single syntax tree,
+   * even if the grammar allows multiple syntax trees for the input.
+   */
+  bool oneParse = true;
+
+  /**
+   * This variable specifies if YAEP should use the costs of the grammar rules
+   * to pick the cheapest syntax tree of an ambiguous input.
+   */
+  bool cost = false;
+
+  /**
+   * This variable specifies if YAEP should try to continue parsing after a
+   * syntax error. If this value is `false`, then the parser stops at the
+   * first error.
+   */
+  bool errorRecovery = true;
+
+  /**
+   * This number specifies how many tokens YAEP has to shift successfully
+   * after a syntax error, before it considers the error recovered.
+   */
+  int recoveryMatch = 3;
+
+  /**
+   * This variable specifies if the converter should reject input, for which
+   * YAEP reports an ambiguous syntax tree.
+   */
+  bool checkAmbiguity = true;
+
+  /**
+   * This number specifies how many threads the converter uses. If the value
+   * is `0`, then the converter uses one thread per processor core. The
+   * converter only uses multiple threads, if the root node of the input is a
+   * mapping.
+   */
+  size_t threads = 1;
+
+  /**
+   * This variable specifies if the lexer should run in a separate thread,
+   * which hands tokens to the parser through a bounded queue.
+   */
+  bool pipeline = false;
+
+  // The following numbers limit the resources the converter uses for a single
+  // input. The converter rejects input that exceeds one of the limits. A value
+  // of `0` disables the corresponding limit.
+
+  /** This number specifies the maximum size of the input in bytes. */
+  size_t maxBytes = 0;
+
+  /**
+   * This number specifies the maximum number of nested block collections
+   * (mappings and sequences).
+   */
+  size_t maxDepth = 0;
+
+  /** This number specifies the maximum length of a scalar in bytes. */
+  size_t maxScalarLength = 0;
+
+  /** This number specifies the maximum number of tokens of the input. */
+  size_t maxTokens = 0;
+
+  /** This number specifies the maximum number of keys the converter adds. */
+  size_t maxKeys = 0;
+
+  /**
+   * If this variable is not `nullptr`, then the converter stops as soon as
+   * the pointed to object reports that the caller cancelled the conversion.
+   */
+  Cancellation const *cancellation = nullptr;
+
+  /**
+   * If this variable is not `nullptr`, then the converter stores the
+   * description of the first error in the pointed to string instead of
+   * printing it to the standard error output. The converter does not change
+   * a string that already contains an error.
+   */
+  std::string *error = nullptr;
+
+  /**
+   * If this variable is not `nullptr`, then the converter stores the size and
+   * the hash of the text it converted in the pointed to object.
+   */
+  Digest *digest = nullptr;
+
+  /**
+   * This variable specifies if a `Converter` should remember the keys of each
+   * converted file and return them again, as long as the file does not
+   * change. The stateless conversion functions ignore this setting.
+   */
+  bool cache = false;
+
+  /**
+   * @brief This function returns settings that convert well formed input as
+   *        fast as possible.
+   *
+   * The returned settings disable error recovery and the check for ambiguous
+   * syntax trees, since the grammar of the converter is unambiguous.
+   *
+   * @return Settings for the conversion of machine generated input
+   */
+  static Options production();
+};
+
+#endif // ELEKTRA_PLUGIN_YAWN_OPTIONS_HPP
@@ -0,0 +1,193 @@
+/**
+ * @file
+ *
+ * @brief This file contains the Elektra storage plugin functions of the YAML
+ *        converter.
+ *
+ * @copyright BSD License (see LICENSE.md or https://www.libelektra.org)
+ */
+
+// -- Imports ------------------------------------------------------------------
+
+#include <exception>
+#include <string>
+
+#include <kdb.hpp>
+#include <kdberrors.h>
+
+#include "convert.hpp"
+#include "plugin.hpp"
+
+using std::exception;
+using std::string;
+
+using CppKey = kdb::Key;
+using CppKeySet = kdb::KeySet;
+using ckdb::keyNew;
+
+namespace {
+
+// -- Functions ----------------------------------------------------------------
+
+/**
+ * @brief This function returns the contract of the plugin.
+ *
+ * @return A key set that describes the functions and properties of the plugin
+ */
+CppKeySet getContract() {
+  return CppKeySet{
+      30,
+      keyNew("system/elektra/modules/yawn", KEY_VALUE,
+             "yawn plugin waits for your orders", KEY_END),
+      keyNew("system/elektra/modules/yawn/exports", KEY_END),
+      keyNew("system/elektra/modules/yawn/exports/open", KEY_FUNC,
+             elektraYawnOpen, KEY_END),
+      keyNew("system/elektra/modules/yawn/exports/close", KEY_FUNC,
+             elektraYawnClose, KEY_END),
+      keyNew("system/elektra/modules/yawn/exports/get", KEY_FUNC,
+             elektraYawnGet, KEY_END),
+      keyNew("system/elektra/modules/yawn/infos/provides", KEY_VALUE,
+             "storage/yaml", KEY_END),
+      keyNew("system/elektra/modules/yawn/infos/placements", KEY_VALUE,
+             "getstorage", KEY_END),
+      keyNew("system/elektra/modules/yawn/infos/version", KEY_VALUE,
+             PLUGINVERSION, KEY_END),
+      KS_END};
+}
+
+/**
+ * @brief This function reads the settings of a plugin instance from its
+ *        configuration.
+ *
+ * The key `/grammar` of the configuration specifies the directory of the
+ * grammar files. If the configuration contains the key `/cache`, then the
+ * plugin only converts files that changed since the last call.
+ *
+ * @param handle This argument stores the plugin instance.
+ *
+ * @return The settings for the converter of the plugin instance
+ */
+Options readOptions(Plugin *handle) {
+  Options options;
+  auto grammar = ckdb::ksLookupByName(ckdb::elektraPluginGetConfig(handle),
+                                      "/grammar", 0);
+  if (grammar) {
+    options.grammarDirectory = ckdb::keyString(grammar);
+  }
+  options.cache = ckdb::ksLookupByName(ckdb::elektraPluginGetConfig(handle),
+                                       "/cache", 0) != nullptr;
+  return options;
+}
+
+} // namespace
+
+// -- Functions ----------------------------------------------------------------
+
+extern "C" {
+
+/**
+ * @brief This function creates the converter of a plugin instance.
+ *
+ * The converter prepares the parser on the first call of `elektraYawnGet`
+ * and keeps it for all following calls of the plugin instance.
+ *
+ * @param handle This argument stores the plugin instance.
+ * @param errorKey The function stores errors in this key.
+ *
+ * @retval ELEKTRA_PLUGIN_STATUS_ERROR if the function was unable to create
+ *                                     the converter
+ * @retval ELEKTRA_PLUGIN_STATUS_SUCCESS otherwise
+ */
+int elektraYawnOpen(Plugin *handle, Key *errorKey ELEKTRA_UNUSED) {
+  try {
+    ckdb::elektraPluginSetData(handle, new Converter{readOptions(handle)});
+  } catch (...) {
+    return ELEKTRA_PLUGIN_STATUS_ERROR;
+  }
+  return ELEKTRA_PLUGIN_STATUS_SUCCESS;
+}
+
+/**
+ * @brief This function releases the converter of a plugin instance.
+ *
+ * @param handle This argument stores the plugin instance.
+ * @param errorKey The function stores errors in this key.
+ *
+ * @retval ELEKTRA_PLUGIN_STATUS_SUCCESS
+ */
+int elektraYawnClose(Plugin *handle, Key *errorKey ELEKTRA_UNUSED) {
+  delete static_cast<Converter *>(ckdb::elektraPluginGetData(handle));
+  ckdb::elektraPluginSetData(handle, nullptr);
+  return ELEKTRA_PLUGIN_STATUS_SUCCESS;
+}
+
+/**
+ * @brief This function converts the YAML file specified by the value of
+ *        `parentKey` and adds the result to `returned`.
+ *
+ * @param handle This argument stores the plugin instance.
+ * @param returned The function adds the converted keys to this key set.
+ * @param parentKey The value of this key specifies the path of the YAML
+ *                  file. The function stores the converted keys below this
+ *                  key and stores errors in it.
+ *
+ * @retval ELEKTRA_PLUGIN_STATUS_ERROR if there was an error converting the
+ *                                     file
+ * @retval ELEKTRA_PLUGIN_STATUS_SUCCESS otherwise
+ */
+int elektraYawnGet(Plugin *handle, KeySet *returned, Key *parentKey) {
+  // The C++ wrappers take over the given key set and key. We release them
+  // again before we return.
+  CppKeySet keys{returned};
+  CppKey parent{parentKey};
+  int status = ELEKTRA_PLUGIN_STATUS_ERROR;
+
+  // No exception may leave the C interface of the plugin
+  try {
+    if (parent.getName() == "system/elektra/modules/yawn") {
+      keys.append(getContract());
+      status = ELEKTRA_PLUGIN_STATUS_SUCCESS;
+    } else {
+      auto converter =
+          static_cast<Converter *>(ckdb::elektraPluginGetData(handle));
+      int const result =
+          converter->addToKeySet(keys, parent, parent.getString());
+      if (result == -2) {
+        ELEKTRA_SET_ERROR_GET(parentKey);
+      } else if (result == -3) {
+        ELEKTRA_SET_ERROR(ELEKTRA_ERROR_PARSE, parentKey,
+                          "Conversion cancelled");
+      } else if (result < 0) {
+        ELEKTRA_SET_ERROR(ELEKTRA_ERROR_PARSE, parentKey,
+                          converter->getError().c_str());
+      } else {
+        status = ELEKTRA_PLUGIN_STATUS_SUCCESS;
+      }
+    }
+  } catch (exception const &error) {
+    ELEKTRA_SET_ERROR(ELEKTRA_ERROR_PARSE, parentKey,
+                      (string{"Unable to convert input: "} + error.what())
+                          .c_str());
+  } catch (...) {
+    ELEKTRA_SET_ERROR(ELEKTRA_ERROR_PARSE, parentKey,
+                      "Unable to convert input: Unknown error");
+  }
+
+  parent.release();
+  keys.release();
+  return status;
+}
+
+/**
+ * @brief This function exports the functions of the plugin.
+ *
+ * @return A plugin instance
+ */
+Plugin *ELEKTRA_PLUGIN_EXPORT(yawn) {
+  return ckdb::elektraPluginExport(
+      "yawn", ckdb::ELEKTRA_PLUGIN_OPEN, &elektraYawnOpen,
+      ckdb::ELEKTRA_PLUGIN_CLOSE, &elektraYawnClose, ckdb::ELEKTRA_PLUGIN_GET,
+      &elektraYawnGet, ckdb::ELEKTRA_PLUGIN_END);
+}
+
+} // extern "C"
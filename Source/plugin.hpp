@@ -0,0 +1,72 @@
+/**
+ * @file
+ *
+ * @brief This file contains the declaration of the Elektra storage plugin
+ *        functions of the YAML converter.
+ *
+ * @copyright BSD License (see LICENSE.md or https://www.libelektra.org)
+ */
+
+#ifndef ELEKTRA_PLUGIN_YAWN_PLUGIN_HPP
+#define ELEKTRA_PLUGIN_YAWN_PLUGIN_HPP
+
+// -- Imports ------------------------------------------------------------------
+
+#include <kdbplugin.h>
+
+using ckdb::Key;
+using ckdb::KeySet;
+using ckdb::Plugin;
+
+// -- Functions ----------------------------------------------------------------
+
+extern "C" {
+
+/**
+ * @brief This function creates the converter of a plugin instance.
+ *
+ * @param handle This argument stores the plugin instance.
+ * @param errorKey The function stores errors in this key.
+ *
+ * @retval ELEKTRA_PLUGIN_STATUS_ERROR if the function was unable to create
+ *                                     the converter
+ * @retval ELEKTRA_PLUGIN_STATUS_SUCCESS otherwise
+ */
+int elektraYawnOpen(Plugin *handle, Key *errorKey);
+
+/**
+ * @brief This function releases the converter of a plugin instance.
+ *
+ * @param handle This argument stores the plugin instance.
+ * @param errorKey The function stores errors in this key.
+ *
+ * @retval ELEKTRA_PLUGIN_STATUS_SUCCESS
+ */
+int elektraYawnClose(Plugin *handle, Key *errorKey);
+
+/**
+ * @brief This function converts the YAML file specified by the value of
+ *        `parentKey` and adds the result to `returned`.
+ *
+ * @param handle This argument stores the plugin instance.
+ * @param returned The function adds the converted keys to this key set.
+ * @param parentKey The value of this key specifies the path of the YAML
+ *                  file. The function stores the converted keys below this
+ *                  key and stores errors in it.
+ *
+ * @retval ELEKTRA_PLUGIN_STATUS_ERROR if there was an error converting the
+ *                                     file
+ * @retval ELEKTRA_PLUGIN_STATUS_SUCCESS otherwise
+ */
+int elektraYawnGet(Plugin *handle, KeySet *returned, Key *parentKey);
+
+/**
+ * @brief This function exports the functions of the plugin.
+ *
+ * @return A plugin instance
+ */
+Plugin *ELEKTRA_PLUGIN_EXPORT(yawn);
+
+} // extern "C"
+
+#endif // ELEKTRA_PLUGIN_YAWN_PLUGIN_HPP
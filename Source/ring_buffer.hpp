@@ -0,0 +1,88 @@
+/**
+ * @file
+ *
+ * @brief This file contains a bounded queue for exactly one producer and one
+ *        consumer thread.
+ *
+ * @copyright BSD License (see LICENSE.md or https://www.libelektra.org)
+ */
+
+#ifndef ELEKTRA_PLUGIN_YAWN_RING_BUFFER_HPP
+#define ELEKTRA_PLUGIN_YAWN_RING_BUFFER_HPP
+
+// -- Imports ------------------------------------------------------------------
+
+#include <array>
+#include <atomic>
+
+// -- Class --------------------------------------------------------------------
+
+/**
+ * @brief This class implements a lock-free ring buffer, which one thread
+ *        fills and another thread drains.
+ *
+ * The producer only writes `tail`, while the consumer only writes `head`.
+ * Both indices therefore only need acquire and release ordering. We store the
+ * indices on separate cache lines to keep the threads from invalidating each
+ * other’s cache line on every operation.
+ *
+ * @tparam Element This argument specifies the type of the stored elements.
+ * @tparam capacity This number specifies the maximum number of stored
+ *                  elements. It has to be a power of two.
+ */
+template <typename Element, size_t capacity> class RingBuffer {
+  static_assert(capacity > 0 && (capacity & (capacity - 1)) == 0,
+                "The capacity of a ring buffer has to be a power of two");
+
+  /** This variable stores the elements of the queue. */
+  std::array<Element, capacity> elements;
+
+  /** This variable stores the number of elements removed by the consumer. */
+  alignas(64) std::atomic<size_t> head{0};
+
+  /** This variable stores the number of elements added by the producer. */
+  alignas(64) std::atomic<size_t> tail{0};
+
+public:
+  /**
+   * @brief This method adds an element to the end of the queue.
+   *
+   * Only the producer thread may call this method.
+   *
+   * @param element This argument specifies the element this method adds.
+   *
+   * @retval true If the method added the element
+   * @retval false If the queue is full
+   */
+  bool push(Element const &element) {
+    size_t const end = tail.load(std::memory_order_relaxed);
+    if (end - head.load(std::memory_order_acquire) >= capacity) {
+      return false;
+    }
+    elements[end & (capacity - 1)] = element;
+    tail.store(end + 1, std::memory_order_release);
+    return true;
+  }
+
+  /**
+   * @brief This method removes the first element of the queue.
+   *
+   * Only the consumer thread may call this method.
+   *
+   * @param element The method stores the removed element in this variable.
+   *
+   * @retval true If the method removed an element
+   * @retval false If the queue is empty
+   */
+  bool pop(Element &element) {
+    size_t const begin = head.load(std::memory_order_relaxed);
+    if (begin == tail.load(std::memory_order_acquire)) {
+      return false;
+    }
+    element = elements[begin & (capacity - 1)];
+    head.store(begin + 1, std::memory_order_release);
+    return true;
+  }
+};
+
+#endif // ELEKTRA_PLUGIN_YAWN_RING_BUFFER_HPP
@@ -0,0 +1,387 @@
+/**
+ * @file
+ *
+ * @brief This file contains functions that store converted keys in a binary
+ *        snapshot and load them again.
+ *
+ * @copyright BSD License (see LICENSE.md or https://www.libelektra.org)
+ */
+
+// -- Imports ------------------------------------------------------------------
+
+#include <cerrno>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <limits>
+#include <sstream>
+#include <unordered_map>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "hash.hpp"
+#include "snapshot.hpp"
+
+using std::cerr;
+using std::endl;
+using std::ifstream;
+using std::numeric_limits;
+using std::ofstream;
+using std::string;
+using std::stringstream;
+using std::unordered_map;
+using std::vector;
+
+using CppKey = kdb::Key;
+using CppKeySet = kdb::KeySet;
+
+namespace {
+
+// -- Globals ------------------------------------------------------------------
+
+/** This constant stores the first bytes of every snapshot. */
+char const magic[8] = {'Y', 'A', 'W', 'N', 'S', 'N', 'A', 'P'};
+
+/** This constant specifies the version of the snapshot format. */
+uint32_t const version = 1;
+
+/**
+ * This constant allows the loader to detect a snapshot written on a machine
+ * with a different byte order.
+ */
+uint32_t const byteOrder = 0x01020304;
+
+/** This constant marks a key without `array` metadata. */
+uint32_t const noArray = numeric_limits<uint32_t>::max();
+
+// -- Classes ------------------------------------------------------------------
+
+/** This structure stores the header of a snapshot. */
+struct Header {
+  /** This variable stores the value of `magic`. */
+  char magic[8];
+
+  /** This number specifies the version of the snapshot format. */
+  uint32_t version;
+
+  /** This variable stores the value of `byteOrder`. */
+  uint32_t byteOrder;
+
+  /** This number stores the size of the source file in bytes. */
+  uint64_t sourceSize;
+
+  /** This number stores the hash of the content of the source file. */
+  uint64_t sourceHash;
+
+  /** This number specifies the number of key records. */
+  uint64_t keys;
+
+  /** This number specifies the size of the string table in bytes. */
+  uint64_t strings;
+};
+
+/**
+ * @brief This structure stores the location of the text of a single key in
+ *        the string table.
+ */
+struct Record {
+  /** This number specifies the offset of the relative key name. */
+  uint32_t name;
+
+  /** This number specifies the length of the relative key name. */
+  uint32_t nameSize;
+
+  /** This number specifies the offset of the value. */
+  uint32_t value;
+
+  /** This number specifies the length of the value. */
+  uint32_t valueSize;
+
+  /**
+   * This number specifies the offset of the `array` metadata, or `noArray`
+   * if the key does not store this metadata.
+   */
+  uint32_t array;
+
+  /** This number specifies the length of the `array` metadata. */
+  uint32_t arraySize;
+};
+
+/** This class builds the string table of a snapshot. */
+class StringTable {
+  /** This variable stores the content of the table. */
+  string table;
+
+  /** This variable maps each stored text to its offset in the table. */
+  unordered_map<string, uint32_t> offsets;
+
+public:
+  /**
+   * @brief This method adds a text to the table, if the table does not
+   *        contain it yet.
+   *
+   * @param text This argument stores the text this method adds.
+   * @param offset The method stores the offset of `text` in this variable.
+   * @param size The method stores the length of `text` in this variable.
+   *
+   * @retval true If the table contains `text`
+   * @retval false If `text` does not fit into the table
+   */
+  bool add(string const &text, uint32_t &offset, uint32_t &size) {
+    auto const stored = offsets.find(text);
+    if (stored != offsets.end()) {
+      offset = stored->second;
+      size = static_cast<uint32_t>(text.size());
+      return true;
+    }
+    if (text.size() >= noArray - table.size()) {
+      return false;
+    }
+    offset = static_cast<uint32_t>(table.size());
+    size = static_cast<uint32_t>(text.size());
+    table += text;
+    offsets.emplace(text, offset);
+    return true;
+  }
+
+  /**
+   * @brief This method returns the content of the table.
+   *
+   * @return The text of all entries of the table
+   */
+  string const &getText() const { return table; }
+};
+
+// -- Functions ----------------------------------------------------------------
+
+/**
+ * @brief This function reads the whole content of a file.
+ *
+ * @param filename This parameter stores the path of the file.
+ * @param text The function stores the content of the file in this variable.
+ *
+ * @retval true If the function was able to read the file
+ * @retval false Otherwise
+ */
+bool readFile(string const &filename, string &text) {
+  ifstream input{filename, ifstream::binary};
+  if (!input.good()) {
+    perror(string("Unable to open file “" + filename + "”").c_str());
+    return false;
+  }
+  stringstream stringStream;
+  stringStream << input.rdbuf();
+  text = stringStream.str();
+  return true;
+}
+
+/**
+ * @brief This function checks if a record refers to text inside the string
+ *        table.
+ *
+ * @param offset This number specifies the offset of the text.
+ * @param size This number specifies the length of the text.
+ * @param strings This number specifies the size of the string table.
+ *
+ * @retval true If the text is part of the string table
+ * @retval false Otherwise
+ */
+bool isInside(uint32_t const offset, uint32_t const size,
+              uint64_t const strings) {
+  return offset <= strings && size <= strings - offset;
+}
+
+/**
+ * @brief This function creates the keys stored in a mapped snapshot.
+ *
+ * @param keySet The function adds the loaded keys to this variable.
+ * @param parent The function stores the loaded keys below this key.
+ * @param source This parameter stores the path of the YAML file the keys
+ *               were converted from.
+ * @param data This argument points to the content of the snapshot.
+ * @param size This number specifies the size of the snapshot in bytes.
+ *
+ * @retval -2 if the function was unable to read `source`
+ * @retval -1 if the snapshot is invalid or does not match `source`
+ * @retval  0 if the function loaded the snapshot successfully
+ */
+int readSnapshot(CppKeySet &keySet, CppKey const &parent, string const &source,
+                 char const *data, size_t const size) {
+  Header header;
+  if (size < sizeof(Header)) {
+    return -1;
+  }
+  memcpy(&header, data, sizeof(Header));
+  if (memcmp(header.magic, magic, sizeof(magic)) != 0 ||
+      header.version != version || header.byteOrder != byteOrder ||
+      header.keys > (size - sizeof(Header)) / sizeof(Record) ||
+      header.strings !=
+          size - sizeof(Header) - header.keys * sizeof(Record)) {
+    return -1;
+  }
+
+  string text;
+  if (!readFile(source, text)) {
+    return -2;
+  }
+  if (text.size() != header.sourceSize || hashText(text) != header.sourceHash) {
+    return -1;
+  }
+
+  char const *records = data + sizeof(Header);
+  char const *strings = records + header.keys * sizeof(Record);
+  CppKeySet keys;
+  for (uint64_t index = 0; index < header.keys; index++) {
+    Record record;
+    memcpy(&record, records + index * sizeof(Record), sizeof(Record));
+    if (!isInside(record.name, record.nameSize, header.strings) ||
+        !isInside(record.value, record.valueSize, header.strings) ||
+        (record.array != noArray &&
+         !isInside(record.array, record.arraySize, header.strings))) {
+      return -1;
+    }
+    CppKey key{parent.getName() +
+                   string{strings + record.name, record.nameSize},
+               KEY_END};
+    key.setString(string{strings + record.value, record.valueSize});
+    if (record.array != noArray) {
+      key.setMeta("array", string{strings + record.array, record.arraySize});
+    }
+    keys.append(key);
+  }
+
+  keySet.append(keys);
+  return 0;
+}
+
+} // namespace
+
+// -- Functions ----------------------------------------------------------------
+
+/**
+ * @brief This function stores converted keys in a snapshot file.
+ *
+ * The snapshot records the size and the hash of the YAML text the keys were
+ * converted from. The function first writes a temporary file and then
+ * renames it, so that readers never see a partially written snapshot.
+ *
+ * @param keys This argument stores the keys this function stores. All keys
+ *             have to be below or the same as `parent`.
+ * @param parent This key specifies the parent key of `keys`. The snapshot
+ *               stores key names relative to this key.
+ * @param source This argument stores the size and the hash of the exact
+ *               text the converter read to produce `keys` (see
+ *               `Options::digest`).
+ * @param filename This parameter stores the path of the snapshot.
+ *
+ * @retval -2 if the function was unable to write the snapshot
+ * @retval -1 if the keys could not be stored in a snapshot
+ * @retval  0 if the function stored the snapshot successfully
+ */
+int writeSnapshot(CppKeySet const &keys, CppKey const &parent,
+                  Digest const &source, string const &filename) {
+  StringTable strings;
+  vector<Record> records;
+  string const parentName = parent.getName();
+  for (auto const &key : keys) {
+    if (!key.isBelowOrSame(parent)) {
+      cerr << "Unable to store key “" << key.getName()
+           << "”, since it is not located below “" << parentName << "”"
+           << endl;
+      return -1;
+    }
+    Record record;
+    record.array = noArray;
+    record.arraySize = 0;
+    if (!strings.add(key.getName().substr(parentName.size()), record.name,
+                     record.nameSize) ||
+        !strings.add(key.getString(), record.value, record.valueSize) ||
+        (key.hasMeta("array") &&
+         !strings.add(key.getMeta<string>("array"), record.array,
+                      record.arraySize))) {
+      cerr << "The keys exceed the maximum size of a snapshot" << endl;
+      return -1;
+    }
+    records.push_back(record);
+  }
+
+  Header header;
+  memcpy(header.magic, magic, sizeof(magic));
+  header.version = version;
+  header.byteOrder = byteOrder;
+  header.sourceSize = source.size;
+  header.sourceHash = source.hash;
+  header.keys = records.size();
+  header.strings = strings.getText().size();
+
+  string const temporary = filename + ".tmp";
+  ofstream output{temporary, ofstream::binary | ofstream::trunc};
+  output.write(reinterpret_cast<char const *>(&header), sizeof(Header));
+  output.write(reinterpret_cast<char const *>(records.data()),
+               records.size() * sizeof(Record));
+  output.write(strings.getText().data(), strings.getText().size());
+  output.close();
+  if (!output || rename(temporary.c_str(), filename.c_str()) != 0) {
+    perror(string("Unable to write snapshot “" + filename + "”").c_str());
+    remove(temporary.c_str());
+    return -2;
+  }
+  return 0;
+}
+
+/**
+ * @brief This function loads the keys stored in a snapshot file and adds
+ *        them to `keySet`.
+ *
+ * The function only loads the snapshot, if the content of the YAML file
+ * `source` still matches the size and hash stored in the snapshot. The
+ * function leaves `keySet` untouched, if it is unable to load the snapshot.
+ *
+ * @param keySet The function adds the loaded keys to this variable.
+ * @param parent The function stores the loaded keys below this key.
+ * @param source This parameter stores the path of the YAML file the keys
+ *               were converted from.
+ * @param filename This parameter stores the path of the snapshot.
+ *
+ * @retval -2 if the function was unable to read `source` or the snapshot
+ * @retval -1 if the snapshot is invalid or does not match `source`
+ * @retval  0 if the function loaded the snapshot successfully
+ */
+int loadSnapshot(CppKeySet &keySet, CppKey const &parent, string const &source,
+                 string const &filename) {
+  int const descriptor = open(filename.c_str(), O_RDONLY);
+  struct stat status;
+  if (descriptor < 0 || fstat(descriptor, &status) != 0) {
+    perror(string("Unable to open snapshot “" + filename + "”").c_str());
+    if (descriptor >= 0) {
+      close(descriptor);
+    }
+    return -2;
+  }
+  size_t const size = static_cast<size_t>(status.st_size);
+  if (size == 0) {
+    close(descriptor);
+    return -1;
+  }
+  void *memory = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, descriptor, 0);
+  close(descriptor);
+  if (memory == MAP_FAILED) {
+    perror(string("Unable to map snapshot “" + filename + "”").c_str());
+    return -2;
+  }
+
+  int const result = readSnapshot(keySet, parent, source,
+                                  static_cast<char const *>(memory), size);
+  munmap(memory, size);
+  if (result == -1) {
+    cerr << "Snapshot “" << filename << "” is invalid or does not match “"
+         << source << "”" << endl;
+  }
+  return result;
+}
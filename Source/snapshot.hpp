@@ -0,0 +1,74 @@
+/**
+ * @file
+ *
+ * @brief This file contains the declaration of functions that store
+ *        converted keys in a binary snapshot and load them again.
+ *
+ * A snapshot starts with a header, followed by a fixed size record for each
+ * key and a table that contains the text of all key names, values and
+ * `array` metadata. Records refer to text via offsets into the table. The
+ * loader therefore maps the snapshot into memory and creates the keys
+ * without parsing any text. All numbers use the byte order of the machine
+ * that wrote the snapshot.
+ *
+ * @copyright BSD License (see LICENSE.md or https://www.libelektra.org)
+ */
+
+#ifndef ELEKTRA_PLUGIN_YAWN_SNAPSHOT_HPP
+#define ELEKTRA_PLUGIN_YAWN_SNAPSHOT_HPP
+
+// -- Imports ------------------------------------------------------------------
+
+#include <string>
+
+#include <kdb.hpp>
+
+#include "hash.hpp"
+
+// -- Functions ----------------------------------------------------------------
+
+/**
+ * @brief This function stores converted keys in a snapshot file.
+ *
+ * The snapshot records the size and the hash of the YAML text the keys were
+ * converted from. The function first writes a temporary file and then
+ * renames it, so that readers never see a partially written snapshot.
+ *
+ * @param keys This argument stores the keys this function stores. All keys
+ *             have to be below or the same as `parent`.
+ * @param parent This key specifies the parent key of `keys`. The snapshot
+ *               stores key names relative to this key.
+ * @param source This argument stores the size and the hash of the exact
+ *               text the converter read to produce `keys` (see
+ *               `Options::digest`).
+ * @param filename This parameter stores the path of the snapshot.
+ *
+ * @retval -2 if the function was unable to write the snapshot
+ * @retval -1 if the keys could not be stored in a snapshot
+ * @retval  0 if the function stored the snapshot successfully
+ */
+int writeSnapshot(kdb::KeySet const &keys, kdb::Key const &parent,
+                  Digest const &source, std::string const &filename);
+
+/**
+ * @brief This function loads the keys stored in a snapshot file and adds
+ *        them to `keySet`.
+ *
+ * The function only loads the snapshot, if the content of the YAML file
+ * `source` still matches the size and hash stored in the snapshot. The
+ * function leaves `keySet` untouched, if it is unable to load the snapshot.
+ *
+ * @param keySet The function adds the loaded keys to this variable.
+ * @param parent The function stores the loaded keys below this key.
+ * @param source This parameter stores the path of the YAML file the keys
+ *               were converted from.
+ * @param filename This parameter stores the path of the snapshot.
+ *
+ * @retval -2 if the function was unable to read `source` or the snapshot
+ * @retval -1 if the snapshot is invalid or does not match `source`
+ * @retval  0 if the function loaded the snapshot successfully
+ */
+int loadSnapshot(kdb::KeySet &keySet, kdb::Key const &parent,
+                 std::string const &source, std::string const &filename);
+
+#endif // ELEKTRA_PLUGIN_YAWN_SNAPSHOT_HPP
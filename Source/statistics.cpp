@@ -0,0 +1,128 @@
+/**
+ * @file
+ *
+ * @brief This file contains the implementation of a class that collects
+ *        timing information and counters for the YAML to `KeySet` converter.
+ *
+ * @copyright BSD License (see LICENSE.md or https://www.libelektra.org)
+ */
+
+// -- Imports ------------------------------------------------------------------
+
+#include <algorithm>
+#include <iomanip>
+#include <sstream>
+
+#include "statistics.hpp"
+#include "token.hpp"
+
+using std::left;
+using std::max;
+using std::right;
+using std::setw;
+using std::string;
+using std::stringstream;
+using std::chrono::duration_cast;
+using std::chrono::microseconds;
+using std::chrono::steady_clock;
+
+// -- Class --------------------------------------------------------------------
+
+/**
+ * @brief This method adds the timings and counters of other statistics to this
+ *        object.
+ *
+ * @param statistics This argument specifies the statistics this method adds.
+ *
+ * @return A reference to this object
+ */
+Statistics &Statistics::operator+=(Statistics const &statistics) {
+  grammar += statistics.grammar;
+  input += statistics.input;
+  lexer += statistics.lexer;
+  parser += statistics.parser;
+  walk += statistics.walk;
+  append += statistics.append;
+  for (auto const &count : statistics.tokens) {
+    tokens[count.first] += count.second;
+  }
+  nodes += statistics.nodes;
+  keys += statistics.keys;
+  peakQueueSize = max(peakQueueSize, statistics.peakQueueSize);
+  return *this;
+}
+
+/**
+ * @brief This constructor starts a new stopwatch.
+ *
+ * @param statistics This argument specifies the statistics the stopwatch
+ *                   updates, or `nullptr` to disable the stopwatch.
+ * @param stage This argument specifies the duration in `statistics` the
+ *              stopwatch adds the elapsed time to.
+ */
+Stopwatch::Stopwatch(Statistics *statistics,
+                     Statistics::Duration Statistics::*const stage)
+    : target{statistics ? &(statistics->*stage) : nullptr} {
+  if (target) {
+    start = steady_clock::now();
+  }
+}
+
+/**
+ * @brief This method returns the time that passed since the creation of the
+ *        stopwatch.
+ *
+ * @return The elapsed time or zero, if the stopwatch is disabled
+ */
+Statistics::Duration Stopwatch::elapsed() const {
+  return target ? steady_clock::now() - start : Statistics::Duration{0};
+}
+
+/**
+ * @brief This method adds the elapsed time to the target of the stopwatch.
+ */
+void Stopwatch::stop() {
+  if (target) {
+    *target += elapsed();
+  }
+}
+
+// -- Function -----------------------------------------------------------------
+
+/**
+ * @brief This function returns a string representation of statistics.
+ *
+ * @param statistics This argument specifies the statistics this function
+ *                   converts to a string.
+ *
+ * @return A text listing the timings and counters of `statistics`
+ */
+string to_string(Statistics const &statistics) {
+  stringstream text;
+  auto const time = [&text](string const &stage,
+                            Statistics::Duration const &duration) {
+    text << "  " << left << setw(22) << stage << right << setw(12)
+         << duration_cast<microseconds>(duration).count() << " µs\n";
+  };
+  auto const count = [&text](string const &name, size_t const number) {
+    text << "  " << left << setw(22) << name << right << setw(12) << number
+         << "\n";
+  };
+
+  text << "— Timings —\n\n";
+  time("Grammar", statistics.grammar);
+  time("Input", statistics.input);
+  time("Lexer", statistics.lexer);
+  time("Parser", statistics.parser);
+  time("Walk", statistics.walk);
+  time("Append", statistics.append);
+
+  text << "\n— Counters —\n\n";
+  for (auto const &tokens : statistics.tokens) {
+    count(typeToString(tokens.first), tokens.second);
+  }
+  count("Syntax tree nodes", statistics.nodes);
+  count("Keys", statistics.keys);
+  count("Peak token queue size", statistics.peakQueueSize);
+  return text.str();
+}
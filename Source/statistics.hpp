@@ -0,0 +1,130 @@
+/**
+ * @file
+ *
+ * @brief This file contains the declaration of a class that collects timing
+ *        information and counters for the YAML to `KeySet` converter.
+ *
+ * @copyright BSD License (see LICENSE.md or https://www.libelektra.org)
+ */
+
+#ifndef ELEKTRA_PLUGIN_YAWN_STATISTICS_HPP
+#define ELEKTRA_PLUGIN_YAWN_STATISTICS_HPP
+
+// -- Imports ------------------------------------------------------------------
+
+#include <chrono>
+#include <map>
+#include <string>
+
+// -- Class --------------------------------------------------------------------
+
+/**
+ * @brief This class stores how long the different stages of a conversion
+ *        took and how much data each stage produced.
+ *
+ * The converter only adds to the values of this class. A caller can therefore
+ * reuse the same object for multiple conversions to get aggregated numbers.
+ */
+class Statistics {
+public:
+  /** This type represents the time spent in a stage of the converter. */
+  using Duration = std::chrono::steady_clock::duration;
+
+  /** This variable stores the time spent reading and parsing the grammar. */
+  Duration grammar{0};
+
+  /** This variable stores the time spent reading the YAML input. */
+  Duration input{0};
+
+  /** This variable stores the time spent inside the lexer. */
+  Duration lexer{0};
+
+  /** This variable stores the time YAEP spent, excluding the lexer. */
+  Duration parser{0};
+
+  /** This variable stores the time spent walking the syntax tree. */
+  Duration walk{0};
+
+  /** This variable stores the time spent appending the converted keys. */
+  Duration append{0};
+
+  /** This map stores the number of emitted tokens for each token type. */
+  std::map<int, size_t> tokens;
+
+  /** This variable stores the number of nodes in the syntax trees. */
+  size_t nodes = 0;
+
+  /** This variable stores the number of converted keys. */
+  size_t keys = 0;
+
+  /**
+   * This variable stores the maximum number of tokens the lexer had to keep
+   * in its queue before it was able to emit them.
+   */
+  size_t peakQueueSize = 0;
+
+  /**
+   * @brief This method adds the timings and counters of other statistics to
+   *        this object.
+   *
+   * @param statistics This argument specifies the statistics this method adds.
+   *
+   * @return A reference to this object
+   */
+  Statistics &operator+=(Statistics const &statistics);
+};
+
+/**
+ * @brief This class measures the time between its creation and a call of
+ *        `stop`.
+ *
+ * If the given statistics are `nullptr`, then the class does not read the
+ * clock at all. This way disabled statistics do not add any noticeable
+ * overhead.
+ */
+class Stopwatch {
+  /** This variable stores the duration `stop` adds the elapsed time to. */
+  Statistics::Duration *target;
+
+  /** This variable stores the time at which the stopwatch started. */
+  std::chrono::steady_clock::time_point start;
+
+public:
+  /**
+   * @brief This constructor starts a new stopwatch.
+   *
+   * @param statistics This argument specifies the statistics the stopwatch
+   *                   updates, or `nullptr` to disable the stopwatch.
+   * @param stage This argument specifies the duration in `statistics` the
+   *              stopwatch adds the elapsed time to.
+   */
+  Stopwatch(Statistics *statistics,
+            Statistics::Duration Statistics::*const stage);
+
+  /**
+   * @brief This method returns the time that passed since the creation of
+   *        the stopwatch.
+   *
+   * @return The elapsed time or zero, if the stopwatch is disabled
+   */
+  Statistics::Duration elapsed() const;
+
+  /**
+   * @brief This method adds the elapsed time to the target of the stopwatch.
+   */
+  void stop();
+};
+
+// -- Function -----------------------------------------------------------------
+
+/**
+ * @brief This function returns a string representation of statistics.
+ *
+ * @param statistics This argument specifies the statistics this function
+ *                   converts to a string.
+ *
+ * @return A text listing the timings and counters of `statistics`
+ */
+std::string to_string(Statistics const &statistics);
+
+#endif // ELEKTRA_PLUGIN_YAWN_STATISTICS_HPP
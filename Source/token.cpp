@@ -9,14 +9,19 @@
 
 // -- Imports ------------------------------------------------------------------
 
+#include <limits>
+#include <stdexcept>
+
 #include "token.hpp"
 
+using std::length_error;
+using std::numeric_limits;
 using std::string;
 using std::to_string;
 
-// -- Functions ----------------------------------------------------------------
+static_assert(sizeof(Token) == 16, "Tokens should fit into 16 bytes");
 
-namespace {
+// -- Functions ----------------------------------------------------------------
 
 /**
  * @brief This function returns the sting representation of a token type.
@@ -55,27 +60,47 @@ string typeToString(int const type)
     return "COMMENT";
   case Token::SINGLE_QUOTED_SCALAR:
     return "SINGLE_QUOTED_SCALAR";
+  case Token::DOCUMENT_START:
+    return "DOCUMENT_START";
+  case Token::DOCUMENT_END:
+    return "DOCUMENT_END";
+  case Token::LITERAL_SCALAR:
+    return "LITERAL_SCALAR";
+  case Token::FOLDED_SCALAR:
+    return "FOLDED_SCALAR";
   default:
     break;
   }
   return "EOF";
 }
 
-} // namespace
-
 // -- Class --------------------------------------------------------------------
 
 /**
  * @brief This constructor creates a token from the given arguments.
  *
  * @param type This number specifies the type of the token.
- * @param location This number specifies the location of the token in the
-                   scanned text.
- * @param text This variable specifies the content that should be stored
- *             in the token.
+ * @param begin This number specifies the offset of the first byte of the
+ *              token in the scanned text.
+ * @param end This number specifies the offset of the byte after the last
+ *            byte of the token in the scanned text.
+ * @param indentation This number specifies the indentation of the content
+ *                    of a block scalar.
  */
-Token::Token(int const type, Location const &location, std::string const &text)
-    : _location{location}, _type{type}, _text{text} {}
+Token::Token(int const type, size_t const begin, size_t const end,
+             size_t const indentation)
+    : _begin{begin}, _length{static_cast<uint32_t>(end - begin)},
+      _type{static_cast<int8_t>(type)},
+      _indentation{static_cast<uint16_t>(indentation)} {
+  if (end - begin > numeric_limits<uint32_t>::max()) {
+    throw length_error("Unable to store token of length " +
+                       to_string(end - begin));
+  }
+  if (indentation > numeric_limits<uint16_t>::max()) {
+    throw length_error("Unable to store token with indentation " +
+                       to_string(indentation));
+  }
+}
 
 /**
  * @brief This method returns the type of the token.
@@ -85,18 +110,27 @@ Token::Token(int const type, Location const &location, std::string const &text)
 int Token::getType() const { return _type; }
 
 /**
- * @brief This method returns the current start position of the token.
+ * @brief This method returns the offset of the first byte of the token.
+ *
+ * @return The start offset of this token in the scanned text
+ */
+size_t Token::getBegin() const { return _begin; }
+
+/**
+ * @brief This method returns the offset of the byte after the token.
  *
- * @return The start position of this token
+ * @return The end offset (exclusive) of this token in the scanned text
  */
-Position Token::getStart() const { return _location.begin; }
+size_t Token::getEnd() const { return _begin + _length; }
 
 /**
- * @brief This method returns the content of the token.
+ * @brief This method returns the indentation of the content of a block
+ *        scalar.
  *
- * @return The text stored inside this token
+ * @return The number of spaces in front of each content line of this token,
+ *         or `0` if the token does not store a block scalar
  */
-string Token::getText() const { return _text; }
+size_t Token::getIndentation() const { return _indentation; }
 
 /**
  * @brief This function returns a string representation of a token.
@@ -104,12 +138,9 @@ string Token::getText() const { return _text; }
  * @param token This argument specifies the token for which this function
  *              creates a string representation.
  *
- * @return A text representing the given token
+ * @return A text representing the type and byte range of the given token
  **/
 string to_string(Token const token) {
-  return "<Token, " + typeToString(token.getType()) + ", " + token.getText() +
-         ", " + to_string(token._location.begin.line) + ":" +
-         to_string(token._location.begin.column) + "–" +
-         to_string(token._location.end.line) + ":" +
-         to_string(token._location.end.column) + ">";
+  return "<Token, " + typeToString(token.getType()) + ", " +
+         to_string(token.getBegin()) + "–" + to_string(token.getEnd()) + ">";
 }
@@ -12,24 +12,40 @@
 
 // -- Imports ------------------------------------------------------------------
 
+#include <cstdint>
 #include <string>
 
-#include "location.hpp"
-#include "token.hpp"
-
 // -- Class --------------------------------------------------------------------
 
-/** This class represents a token emitted by a lexer. */
+/**
+ * @brief This class represents a token emitted by a lexer.
+ *
+ * A token only stores its type, the byte range it covers in the scanned text
+ * and, for block scalars, the indentation of their content. The lexer uses
+ * this range to retrieve the content and the location of the token on
+ * demand. The indentation is only known while the lexer scans the header
+ * and the lines of a block scalar. The token keeps it, so that `getText` of
+ * the lexer can add it to the header of the scalar without scanning the
+ * lines again. The indentation uses the former padding bytes. This way a
+ * token still only requires 16 bytes and the lexer can store tokens in a
+ * contiguous array.
+ */
 class Token {
 
-  /** This variable stores the location of this token in the scanned text. */
-  Location _location;
+  /** This variable stores the offset of the first byte of the token. */
+  size_t _begin;
+
+  /** This attribute stores the length of the token in bytes. */
+  uint32_t _length;
 
   /** This attribute stores a number representing the kind of the token. */
-  int _type;
+  int8_t _type;
 
-  /** This variable stores the content stored inside the token. */
-  std::string _text;
+  /**
+   * This attribute stores the indentation (in number of spaces) of the
+   * content of a block scalar. For all other tokens the value is `0`.
+   */
+  uint16_t _indentation;
 
 public:
   /** This token type starts the YAML stream. */
@@ -56,6 +72,14 @@ public:
   static const int COMMENT = 11;
   /** This token type specifies that the token stores a single quoted scalar. */
   static const int SINGLE_QUOTED_SCALAR = 12;
+  /** This token type indicates the start of a document. */
+  static const int DOCUMENT_START = 13;
+  /** This token type indicates the end of a document. */
+  static const int DOCUMENT_END = 14;
+  /** This token type specifies that the token stores a literal scalar. */
+  static const int LITERAL_SCALAR = 15;
+  /** This token type specifies that the token stores a folded scalar. */
+  static const int FOLDED_SCALAR = 16;
 
   /**
    * @brief This function returns a string representation of a token.
@@ -63,20 +87,29 @@ public:
    * @param token This argument specifies the token for which this function
    *              creates a string representation.
    *
-   * @return A text representing the given token
+   * @return A text representing the type and byte range of the given token
    **/
   friend std::string to_string(Token token);
 
+  /**
+   * @brief This constructor creates a token with an unspecified type and
+   *        range.
+   */
+  Token() = default;
+
   /**
    * @brief This constructor creates a token from the given arguments.
    *
    * @param type This number specifies the type of the token.
-   * @param location This number specifies the location of the token in the
-   *                 scanned text.
-   * @param text This variable specifies the content that should be stored
-   *             in the token.
+   * @param begin This number specifies the offset of the first byte of the
+   *              token in the scanned text.
+   * @param end This number specifies the offset of the byte after the last
+   *            byte of the token in the scanned text.
+   * @param indentation This number specifies the indentation of the content
+   *                    of a block scalar.
    */
-  Token(int const type, Location const &location, std::string const &text);
+  Token(int const type, size_t const begin, size_t const end,
+        size_t const indentation = 0);
 
   /**
    * @brief This method returns the type of the token.
@@ -86,18 +119,36 @@ public:
   int getType() const;
 
   /**
-   * @brief This method returns the current start position of the token.
+   * @brief This method returns the offset of the first byte of the token.
    *
-   * @return The start position of this token
+   * @return The start offset of this token in the scanned text
    */
-  Position getStart() const;
+  size_t getBegin() const;
 
   /**
-   * @brief This method returns the content of the token.
+   * @brief This method returns the offset of the byte after the token.
    *
-   * @return The text stored inside this token
+   * @return The end offset (exclusive) of this token in the scanned text
    */
-  std::string getText() const;
+  size_t getEnd() const;
+
+  /**
+   * @brief This method returns the indentation of the content of a block
+   *        scalar.
+   *
+   * @return The number of spaces in front of each content line of this
+   *         token, or `0` if the token does not store a block scalar
+   */
+  size_t getIndentation() const;
 };
 
+/**
+ * @brief This function returns the string representation of a token type.
+ *
+ * @param type This variable specifies the token type that should be converted.
+ *
+ * @return A string representation of the given token type
+ */
+std::string typeToString(int const type);
+
 #endif // ELEKTRA_PLUGIN_YAWN_TOKEN_HPP
@@ -0,0 +1,278 @@
+/**
+ * @file
+ *
+ * @brief This file contains a trie that stores converted keys with shared
+ *        prefixes.
+ *
+ * @copyright BSD License (see LICENSE.md or https://www.libelektra.org)
+ */
+
+// -- Imports ------------------------------------------------------------------
+
+#include <stdexcept>
+
+#include "listener.hpp"
+#include "trie.hpp"
+
+using std::length_error;
+using std::move;
+using std::overflow_error;
+using std::string;
+using std::to_string;
+using std::vector;
+
+using kdb::Key;
+using kdb::KeySet;
+
+namespace {
+
+// -- Functions ----------------------------------------------------------------
+
+/**
+ * @brief This function combines a parent node and a base name into a single
+ *        number.
+ *
+ * @param parent This number specifies the parent node.
+ * @param name This number specifies the interned base name of the child.
+ *
+ * @return A number that identifies the child of `parent` called `name`
+ */
+inline uint64_t childId(uint32_t const parent, uint32_t const name) {
+  return static_cast<uint64_t>(parent) << 32 | name;
+}
+
+} // namespace
+
+// -- Class --------------------------------------------------------------------
+
+/**
+ * @brief This method returns the index of an interned base name.
+ *
+ * @param name This argument stores the base name this method interns.
+ *
+ * @return The index of `name` in `names`
+ */
+uint32_t KeyTrie::intern(string const &name) {
+  auto const stored = nameIndices.find(name);
+  if (stored != nameIndices.end()) {
+    return stored->second;
+  }
+  if (names.size() >= none) {
+    throw length_error("Input exceeds the maximum number of base names");
+  }
+  uint32_t const index = static_cast<uint32_t>(names.size());
+  names.push_back(&nameIndices.emplace(name, index).first->first);
+  return index;
+}
+
+/**
+ * @brief This method returns the child of a node with the given base name
+ *        and creates it, if it does not exist yet.
+ *
+ * @param parent This number specifies the parent node.
+ * @param name This argument stores the base name of the child.
+ *
+ * @return The index of the child node
+ */
+uint32_t KeyTrie::addChild(uint32_t const parent, string const &name) {
+  uint32_t const nameIndex = intern(name);
+  auto const stored = children.find(childId(parent, nameIndex));
+  if (stored != children.end()) {
+    return stored->second;
+  }
+  if (nodes.size() >= none) {
+    throw length_error("Input exceeds the maximum number of nodes");
+  }
+
+  uint32_t const child = static_cast<uint32_t>(nodes.size());
+  nodes.push_back(Node{nameIndex, none, none, none, none, none});
+  if (nodes[parent].lastChild == none) {
+    nodes[parent].firstChild = child;
+  } else {
+    nodes[nodes[parent].lastChild].nextSibling = child;
+  }
+  nodes[parent].lastChild = child;
+  children.emplace(childId(parent, nameIndex), child);
+  return child;
+}
+
+/**
+ * @brief This method stores a key in a node.
+ *
+ * @param node This number specifies the node that stores the key.
+ * @param value This argument stores the value of the key.
+ */
+void KeyTrie::setValue(uint32_t const node, string const &value) {
+  // A new key replaces the metadata of a previous key with the same name
+  nodes[node].array = none;
+  if (nodes[node].value != none) {
+    values[nodes[node].value] = value;
+    return;
+  }
+  if (maxKeys > 0 && keys >= maxKeys) {
+    throw length_error("Input exceeds the maximum number of " +
+                       to_string(maxKeys) + " keys");
+  }
+  nodes[node].value = static_cast<uint32_t>(values.size());
+  values.push_back(value);
+  keys++;
+}
+
+/**
+ * @brief This method adds the keys of a node and all of its descendants
+ *        to a key set.
+ *
+ * @param node This number specifies the root of the subtree.
+ * @param key This key stores the name of `node`.
+ * @param keySet The method adds the keys to this key set.
+ */
+void KeyTrie::addKeys(uint32_t const node, Key const &key,
+                      KeySet &keySet) const {
+  if (nodes[node].value != none) {
+    Key stored{key.getName(), KEY_END};
+    stored.setString(values[nodes[node].value]);
+    if (nodes[node].array != none) {
+      stored.setMeta("array", *names[nodes[node].array]);
+    }
+    keySet.append(stored);
+  }
+  for (uint32_t child = nodes[node].firstChild; child != none;
+       child = nodes[child].nextSibling) {
+    Key childKey{key.getName(), KEY_END};
+    childKey.addBaseName(*names[nodes[child].name]);
+    addKeys(child, childKey, keySet);
+  }
+}
+
+/**
+ * @brief This constructor creates an empty trie below the given parent
+ *        key.
+ *
+ * @param parent This argument specifies the parent key of all keys the
+ *               trie stores.
+ * @param limit This number specifies the maximum number of keys the trie
+ *              stores. If the walker produces more keys, then the trie
+ *              throws a `length_error`.
+ */
+KeyTrie::KeyTrie(Key const &parent, size_t const limit)
+    : parentName{parent.getName()}, maxKeys{limit} {
+  nodes.push_back(Node{none, none, none, none, none, none});
+  parents.push(0);
+}
+
+/**
+ * @brief This function will be called after the walker exits a value node.
+ *
+ * @param text This variable contains the text stored in the value.
+ */
+void KeyTrie::exitValue(string text) {
+  setValue(parents.top(), scalarToText(move(text)));
+}
+
+/**
+ * @brief This function will be called after the walker exits a key node.
+ *
+ * @param text This variable contains the text of the key.
+ */
+void KeyTrie::exitKey(string text) {
+  parents.push(addChild(parents.top(), scalarToText(move(text))));
+}
+
+/**
+ * @brief This function will be called after the walker exits the node for a
+ *        key-value pair.
+ *
+ * @param matchedValue This variable specifies if the pair contains a value
+ *                     or not.
+ */
+void KeyTrie::exitPair(bool const matchedValue) {
+  if (!matchedValue) {
+    // Add key with empty value
+    setValue(parents.top(), "");
+  }
+  parents.pop();
+}
+
+/**
+ * @brief This function will be called before the walker enters a sequence
+ *        node.
+ */
+void KeyTrie::enterSequence() { indices.push(0); }
+
+/**
+ * @brief This function will be called after the walker exits a sequence
+ *        node.
+ */
+void KeyTrie::exitSequence() {
+  string last;
+  if (indices.top() > 0) {
+    appendArrayBaseName(last, indices.top() - 1);
+  }
+  setValue(parents.top(), "");
+  nodes[parents.top()].array = intern(last);
+  indices.pop();
+}
+
+/**
+ * @brief This function will be called before the walker enters an element
+ *        node.
+ */
+void KeyTrie::enterElement() {
+  if (indices.top() >= UINTMAX_MAX)
+    throw overflow_error("Unable to increase array index for array “" +
+                         parentName + "”");
+
+  elementName.clear();
+  appendArrayBaseName(elementName, indices.top()++);
+  parents.push(addChild(parents.top(), elementName));
+}
+
+/**
+ * @brief This function will be called after the walker exits an element
+ *        node.
+ */
+void KeyTrie::exitElement() { parents.pop(); }
+
+/**
+ * @brief This method returns the number of keys stored in the trie.
+ *
+ * @return The number of keys
+ */
+size_t KeyTrie::size() const { return keys; }
+
+/**
+ * @brief This method creates the keys stored in the trie.
+ *
+ * @return A key set that contains all keys of the trie
+ */
+KeySet KeyTrie::getKeySet() const { return getKeySet(vector<string>{}); }
+
+/**
+ * @brief This method creates the keys of a subtree of the trie.
+ *
+ * @param path This variable stores the (unescaped) base names of the keys
+ *             leading from the parent key to the root of the subtree.
+ *
+ * @return A key set that contains the root of the subtree and all keys
+ *         below it, or an empty key set if the trie does not contain
+ *         `path`
+ */
+KeySet KeyTrie::getKeySet(vector<string> const &path) const {
+  KeySet keySet;
+  Key key{parentName, KEY_END};
+  uint32_t node = 0;
+  for (auto const &name : path) {
+    auto const nameIndex = nameIndices.find(name);
+    if (nameIndex == nameIndices.end()) {
+      return keySet;
+    }
+    auto const child = children.find(childId(node, nameIndex->second));
+    if (child == children.end()) {
+      return keySet;
+    }
+    node = child->second;
+    key.addBaseName(name);
+  }
+  addKeys(node, key, keySet);
+  return keySet;
+}
@@ -0,0 +1,241 @@
+/**
+ * @file
+ *
+ * @brief This file contains the declaration of a trie that stores converted
+ *        keys with shared prefixes.
+ *
+ * @copyright BSD License (see LICENSE.md or https://www.libelektra.org)
+ */
+
+#ifndef ELEKTRA_PLUGIN_YAWN_TRIE_HPP
+#define ELEKTRA_PLUGIN_YAWN_TRIE_HPP
+
+// -- Imports ------------------------------------------------------------------
+
+#include <cstdint>
+#include <stack>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <kdb.hpp>
+
+// -- Class --------------------------------------------------------------------
+
+/**
+ * @brief This class stores the keys of a YAML file as a trie.
+ *
+ * Each node of the trie stores a single base name. All keys below the same
+ * parent therefore share the nodes of their common prefix, and every
+ * distinct base name is stored only once. The class implements the static
+ * sink interface described in `walk.hpp`, which allows the tree walker to
+ * build the trie directly. The methods `getKeySet` create Elektra keys on
+ * demand.
+ */
+class KeyTrie {
+  /** This constant marks a missing node, value or base name. */
+  static uint32_t const none = UINT32_MAX;
+
+  /** This structure stores a single node of the trie. */
+  struct Node {
+    /** This number specifies the interned base name of the node. */
+    uint32_t name;
+
+    /** This number specifies the first child of the node. */
+    uint32_t firstChild;
+
+    /** This number specifies the last child of the node. */
+    uint32_t lastChild;
+
+    /** This number specifies the next node with the same parent. */
+    uint32_t nextSibling;
+
+    /**
+     * This number specifies the index of the value of the node, or `none` if
+     * the node does not store a key.
+     */
+    uint32_t value;
+
+    /**
+     * This number specifies the interned `array` metadata of the node, or
+     * `none` if the key does not store this metadata.
+     */
+    uint32_t array;
+  };
+
+  /** This variable stores the name of the parent key of all keys. */
+  std::string parentName;
+
+  /** This variable stores all nodes. The first node is the parent key. */
+  std::vector<Node> nodes;
+
+  /**
+   * This variable stores the text of all interned base names and maps each
+   * of them to its index in `names`.
+   */
+  std::unordered_map<std::string, uint32_t> nameIndices;
+
+  /**
+   * This variable points to the text of each interned base name stored in
+   * `nameIndices`. Rehashing the map does not move its elements.
+   */
+  std::vector<std::string const *> names;
+
+  /**
+   * This variable maps a parent node and the base name of a child, packed
+   * into a single number, to the child node.
+   */
+  std::unordered_map<uint64_t, uint32_t> children;
+
+  /** This variable stores the values of all keys. */
+  std::vector<std::string> values;
+
+  /** This stack stores the node for each level of the current key name. */
+  std::stack<uint32_t> parents;
+
+  /** This stack stores indices for the next array elements. */
+  std::stack<uintmax_t> indices;
+
+  /** This variable stores the base name of the last array element. */
+  std::string elementName;
+
+  /** This number specifies the number of nodes that store a key. */
+  size_t keys = 0;
+
+  /**
+   * This number specifies the maximum number of keys the trie stores. The
+   * value `0` disables this limit.
+   */
+  size_t maxKeys;
+
+  /**
+   * @brief This method returns the index of an interned base name.
+   *
+   * @param name This argument stores the base name this method interns.
+   *
+   * @return The index of `name` in `names`
+   */
+  uint32_t intern(std::string const &name);
+
+  /**
+   * @brief This method returns the child of a node with the given base name
+   *        and creates it, if it does not exist yet.
+   *
+   * @param parent This number specifies the parent node.
+   * @param name This argument stores the base name of the child.
+   *
+   * @return The index of the child node
+   */
+  uint32_t addChild(uint32_t const parent, std::string const &name);
+
+  /**
+   * @brief This method stores a key in a node.
+   *
+   * @param node This number specifies the node that stores the key.
+   * @param value This argument stores the value of the key.
+   */
+  void setValue(uint32_t const node, std::string const &value);
+
+  /**
+   * @brief This method adds the keys of a node and all of its descendants
+   *        to a key set.
+   *
+   * @param node This number specifies the root of the subtree.
+   * @param key This key stores the name of `node`.
+   * @param keySet The method adds the keys to this key set.
+   */
+  void addKeys(uint32_t const node, kdb::Key const &key,
+               kdb::KeySet &keySet) const;
+
+public:
+  /**
+   * @brief This constructor creates an empty trie below the given parent
+   *        key.
+   *
+   * @param parent This argument specifies the parent key of all keys the
+   *               trie stores.
+   * @param limit This number specifies the maximum number of keys the trie
+   *              stores. If the walker produces more keys, then the trie
+   *              throws a `length_error`.
+   */
+  KeyTrie(kdb::Key const &parent, size_t const limit = 0);
+
+  // The interned base names point into the map of the trie
+  KeyTrie(KeyTrie const &) = delete;
+  KeyTrie &operator=(KeyTrie const &) = delete;
+
+  /**
+   * @brief This function will be called after the walker exits a value node.
+   *
+   * @param text This variable contains the text stored in the value.
+   */
+  void exitValue(std::string text);
+
+  /**
+   * @brief This function will be called after the walker exits a key node.
+   *
+   * @param text This variable contains the text of the key.
+   */
+  void exitKey(std::string text);
+
+  /**
+   * @brief This function will be called after the walker exits the node for a
+   *        key-value pair.
+   *
+   * @param matchedValue This variable specifies if the pair contains a value
+   *                     or not.
+   */
+  void exitPair(bool const matchedValue);
+
+  /**
+   * @brief This function will be called before the walker enters a sequence
+   *        node.
+   */
+  void enterSequence();
+
+  /**
+   * @brief This function will be called after the walker exits a sequence
+   *        node.
+   */
+  void exitSequence();
+
+  /**
+   * @brief This function will be called before the walker enters an element
+   *        node.
+   */
+  void enterElement();
+
+  /**
+   * @brief This function will be called after the walker exits an element
+   *        node.
+   */
+  void exitElement();
+
+  /**
+   * @brief This method returns the number of keys stored in the trie.
+   *
+   * @return The number of keys
+   */
+  size_t size() const;
+
+  /**
+   * @brief This method creates the keys stored in the trie.
+   *
+   * @return A key set that contains all keys of the trie
+   */
+  kdb::KeySet getKeySet() const;
+
+  /**
+   * @brief This method creates the keys of a subtree of the trie.
+   *
+   * @param path This variable stores the (unescaped) base names of the keys
+   *             leading from the parent key to the root of the subtree.
+   *
+   * @return A key set that contains the root of the subtree and all keys
+   *         below it, or an empty key set if the trie does not contain
+   *         `path`
+   */
+  kdb::KeySet getKeySet(std::vector<std::string> const &path) const;
+};
+
+#endif // ELEKTRA_PLUGIN_YAWN_TRIE_HPP
@@ -1,7 +1,8 @@
 /**
  * @file
  *
- * @brief This file contains the declaration of a tree walker function.
+ * @brief This file contains a tree walker function that forwards the nodes
+ *        of a syntax tree to a sink.
  *
  * @copyright BSD License (see LICENSE.md or https://www.libelektra.org)
  */
@@ -11,20 +12,165 @@
 
 // -- Imports ------------------------------------------------------------------
 
-#include <kdb.hpp>
+#include <cassert>
+#include <cstring>
+#include <string>
 
 #include <yaep.h>
 
-// -- Function -----------------------------------------------------------------
+#include "cancellation.hpp"
+#include "lexer.hpp"
+
+// -- Globals ------------------------------------------------------------------
+
+/**
+ * This constant specifies after how many visited nodes the walker checks, if
+ * the caller cancelled the conversion.
+ */
+size_t const walkCancellationInterval = 1024;
+
+// -- Functions ----------------------------------------------------------------
+
+/**
+ * @brief This function returns the string representation of a tree node.
+ *
+ * @param node This argument stores the tree node that this function converts to
+ *             a string.
+ * @param lexer This argument stores the lexer that produced the tokens
+ *              referenced by the tree.
+ * @param indent This text specifies the indentation of the returned lines.
+ *
+ * @return A string representation of the given node
+ */
+std::string toString(yaep_tree_node const *const node, Lexer const &lexer,
+                     std::string const indent = "");
+
+/**
+ * @brief This function will be called before the walker enters an abstract
+ *        tree node.
+ *
+ * @param sink The function calls methods of this object when it encounters
+ *             an abstract node with a certain name.
+ * @param anode This argument stores the abstract tree node
+ */
+template <typename Sink>
+void executeEnter(Sink &sink, yaep_anode const &anode) {
+  if (strcmp(anode.name, "sequence") == 0) {
+    sink.enterSequence();
+  } else if (strcmp(anode.name, "element") == 0) {
+    sink.enterElement();
+  }
+}
+
+/**
+ * @brief This function will be called after the walker exits an abstract
+ *        tree node.
+ *
+ * @param sink The function calls methods of this object when it encountered
+ *             an abstract node with a certain name.
+ * @param lexer This argument stores the lexer that produced the tokens
+ *              referenced by the tree.
+ * @param anode This argument stores the abstract tree node
+ */
+template <typename Sink>
+void executeExit(Sink &sink, Lexer const &lexer, yaep_anode const &anode) {
+  if (strcmp(anode.name, "value") == 0) {
+    auto token = anode.children[0]->val.term.attr;
+    sink.exitValue(lexer.getText(lexer.getToken(token)));
+  } else if (strcmp(anode.name, "key") == 0) {
+    auto token = anode.children[0]->val.term.attr;
+    sink.exitKey(lexer.getText(lexer.getToken(token)));
+  } else if (strcmp(anode.name, "pair") == 0) {
+    bool matchedValue =
+        anode.children[1]->type != yaep_tree_node_type::YAEP_NIL;
+    sink.exitPair(matchedValue);
+  } else if (strcmp(anode.name, "sequence") == 0) {
+    sink.exitSequence();
+  } else if (strcmp(anode.name, "element") == 0) {
+    sink.exitElement();
+  }
+}
+
+/**
+ * @brief This function traverses a tree executing methods of a sink.
+ *
+ * @param sink The function calls methods of this object while it traverses
+ *             the tree.
+ * @param lexer This argument stores the lexer that produced the tokens
+ *              referenced by the tree.
+ * @param node This argument stores the tree node that this function traverses.
+ * @param cancellation If this argument is not `nullptr`, then the function
+ *                     throws `Cancelled` after the caller cancelled the
+ *                     conversion.
+ * @param visited This variable stores the number of nodes the walker visited.
+ */
+template <typename Sink>
+void executeSinkMethods(Sink &sink, Lexer const &lexer,
+                        yaep_tree_node const *node,
+                        Cancellation const *cancellation, size_t &visited) {
+  if (cancellation && ++visited % walkCancellationInterval == 0 &&
+      cancellation->isCancelled()) {
+    throw Cancelled{};
+  }
+  if (node->type == yaep_tree_node_type::YAEP_TERM ||
+      node->type == yaep_tree_node_type::YAEP_NIL) {
+    return;
+  }
+  assert(node->type == yaep_tree_node_type::YAEP_ANODE &&
+         "Found unexpected node type");
+
+  // Node is abstract
+  yaep_anode const &anode = node->val.anode;
+
+  executeEnter(sink, anode);
+
+  yaep_tree_node **children = anode.children;
+  for (size_t child = 0; children[child]; child++) {
+    executeSinkMethods(sink, lexer, children[child], cancellation, visited);
+  }
+
+  executeExit(sink, lexer, anode);
+}
 
 /**
  * @brief This function walks a syntax tree calling methods of the given
- *        listener.
+ *        sink.
+ *
+ * The walker does not require a common base class. Instead every sink has to
+ * provide the methods
+ *
+ * - `void enterSequence()`,
+ * - `void exitSequence()`,
+ * - `void enterElement()`,
+ * - `void exitElement()`,
+ * - `void exitKey(std::string text)`,
+ * - `void exitValue(std::string text)`, and
+ * - `void exitPair(bool matchedValue)`.
+ *
+ * The walker hands the text of keys and values to the sink as temporary
+ * strings, which the sink may take over. The compiler resolves all of these
+ * calls statically, which allows it to inline the methods of the sink into
+ * the walker. `Listener` is the sink that converts the tree to a key set.
+ *
+ * @tparam Sink This argument specifies the type of the sink.
  *
- * @param listener This argument specifies the listener which this function
- *                 uses to convert the syntax tree to a key set.
+ * @param sink This argument specifies the sink which this function uses to
+ *             convert the syntax tree.
+ * @param lexer This argument stores the lexer that produced the tokens
+ *              referenced by the syntax tree.
  * @param root This variable stores the root of the tree this function visits.
+ * @param cancellation If this argument is not `nullptr`, then the function
+ *                     checks periodically, if the caller cancelled the
+ *                     conversion. In this case it throws `Cancelled`.
  */
-void walk(Listener &listener, yaep_tree_node const *root);
+template <typename Sink>
+void walk(Sink &sink, Lexer const &lexer, yaep_tree_node const *root,
+          Cancellation const *cancellation = nullptr) {
+  if (cancellation && cancellation->isCancelled()) {
+    throw Cancelled{};
+  }
+  size_t visited = 0;
+  executeSinkMethods(sink, lexer, root, cancellation, visited);
+}
 
 #endif // ELEKTRA_PLUGIN_YAWN_WALK_HPP
@@ -1,11 +1,18 @@
 // -- Imports ------------------------------------------------------------------
 
+#include <algorithm>
+#include <chrono>
+#include <fstream>
 #include <iostream>
+#include <iterator>
+#include <stdexcept>
 #include <stdlib.h>
 
 #include <kdb.hpp>
 
 #include "convert.hpp"
+#include "snapshot.hpp"
+#include "trie.hpp"
 
 using ckdb::keyNew;
 using kdb::Key;
@@ -14,31 +21,508 @@ using kdb::KeySet;
 using std::cerr;
 using std::cout;
 using std::endl;
+using std::find;
+using std::ifstream;
+using std::istreambuf_iterator;
+using std::logic_error;
+using std::min;
+using std::streamsize;
 using std::string;
+using std::vector;
+using std::chrono::milliseconds;
+
+// -- Classes ------------------------------------------------------------------
+
+/** This enumeration specifies the formats the tool uses to print keys. */
+enum class Format {
+  /** Print a human readable listing of the form `name: value` */
+  LISTING,
+  /** Print a JSON object with the fields `name` and `value` per line */
+  JSON,
+  /** Print the name and the value of each key followed by a null byte */
+  NUL
+};
+
+/**
+ * @brief This class collects output and writes it to the standard output in
+ *        large blocks.
+ */
+class Output {
+  /**
+   * This constant specifies the number of bytes the buffer collects before
+   * the class writes them.
+   */
+  static size_t const capacity = 1 << 16;
+
+  /** This variable stores the output the class did not write yet. */
+  string buffer;
+
+public:
+  /** This constructor creates an empty output buffer. */
+  Output() { buffer.reserve(capacity); }
+
+  /** This destructor writes the remaining content of the buffer. */
+  ~Output() { flush(); }
+
+  /**
+   * @brief This method adds text to the output.
+   *
+   * @param text This argument points to the text this method adds.
+   * @param size This number specifies the length of `text` in bytes.
+   */
+  void append(char const *text, size_t const size) {
+    if (buffer.size() + size > capacity) {
+      flush();
+    }
+    buffer.append(text, size);
+  }
+
+  /**
+   * @brief This method adds a single character to the output.
+   *
+   * @param character This argument stores the character this method adds.
+   */
+  void append(char const character) {
+    if (buffer.size() >= capacity) {
+      flush();
+    }
+    buffer.push_back(character);
+  }
+
+  /** This method writes the content of the buffer to the standard output. */
+  void flush() {
+    cout.write(buffer.data(), static_cast<streamsize>(buffer.size()));
+    cout.flush();
+    buffer.clear();
+  }
+};
 
 // -- Functions ----------------------------------------------------------------
 
-void printOutput(KeySet const &keys) {
-  cout << endl << "— Output ————" << endl << endl;
-  for (auto key : keys) {
-    cout << key.getName() << ":"
-         << (key.getStringSize() > 1 ? " " + key.getString() : "") << endl;
+/**
+ * @brief This function returns the length of the UTF-8 sequence at the start
+ *        of a text.
+ *
+ * @param text This argument points to the first byte of the sequence.
+ * @param size This number specifies the number of bytes available at `text`.
+ *
+ * @return The number of bytes of the sequence, or `0` if `text` does not
+ *         start with a well formed UTF-8 sequence
+ */
+size_t utf8Length(unsigned char const *text, size_t const size) {
+  unsigned char const first = text[0];
+  size_t length;
+  // The range of the second byte excludes overlong encodings, surrogates and
+  // code points above U+10FFFF
+  unsigned char low = 0x80;
+  unsigned char high = 0xbf;
+  if (first < 0x80) {
+    return 1;
+  } else if (first >= 0xc2 && first <= 0xdf) {
+    length = 2;
+  } else if (first >= 0xe0 && first <= 0xef) {
+    length = 3;
+    low = first == 0xe0 ? 0xa0 : low;
+    high = first == 0xed ? 0x9f : high;
+  } else if (first >= 0xf0 && first <= 0xf4) {
+    length = 4;
+    low = first == 0xf0 ? 0x90 : low;
+    high = first == 0xf4 ? 0x8f : high;
+  } else {
+    return 0;
+  }
+  if (size < length || text[1] < low || text[1] > high) {
+    return 0;
+  }
+  for (size_t index = 2; index < length; index++) {
+    if (text[index] < 0x80 || text[index] > 0xbf) {
+      return 0;
+    }
+  }
+  return length;
+}
+
+/**
+ * @brief This function adds text to the output and escapes it as content of
+ *        a JSON string.
+ *
+ * JSON text has to be valid UTF-8. The function therefore replaces every byte
+ * that is not part of a well formed UTF-8 sequence with the replacement
+ * character U+FFFD.
+ *
+ * @param output This argument stores the output this function extends.
+ * @param text This argument points to the text this function adds.
+ * @param size This number specifies the length of `text` in bytes.
+ */
+void appendJson(Output &output, char const *text, size_t const size) {
+  char const *const hexadecimal = "0123456789abcdef";
+  auto const bytes = reinterpret_cast<unsigned char const *>(text);
+  size_t start = 0;
+  for (size_t index = 0; index < size; index++) {
+    unsigned char const character = bytes[index];
+    if (character >= 0x80) {
+      size_t const length = utf8Length(bytes + index, size - index);
+      if (length > 0) {
+        index += length - 1;
+        continue;
+      }
+    } else if (character >= 0x20 && character != '"' && character != '\\') {
+      continue;
+    }
+    // Copy the characters that need no escaping in one block
+    output.append(text + start, index - start);
+    start = index + 1;
+    output.append('\\');
+    switch (character) {
+    case '"':
+    case '\\':
+      output.append(static_cast<char>(character));
+      break;
+    case '\n':
+      output.append('n');
+      break;
+    case '\t':
+      output.append('t');
+      break;
+    case '\r':
+      output.append('r');
+      break;
+    default:
+      if (character >= 0x80) {
+        output.append("ufffd", 5);
+      } else {
+        output.append("u00", 3);
+        output.append(hexadecimal[character >> 4]);
+        output.append(hexadecimal[character & 0xf]);
+      }
+    }
+  }
+  output.append(text + start, size - start);
+}
+
+/**
+ * @brief This function prints the given keys to the standard output.
+ *
+ * @param keys This argument stores the keys this function prints.
+ * @param format This value specifies the format of the output.
+ */
+void printOutput(KeySet const &keys, Format const format) {
+  Output output;
+  if (format == Format::LISTING) {
+    string const header = "\n— Output ————\n\n";
+    output.append(header.data(), header.size());
+  }
+  for (auto const &key : keys) {
+    // Use the text stored in the key directly to avoid a copy per key
+    char const *name = ckdb::keyName(key.getKey());
+    size_t const nameSize =
+        static_cast<size_t>(ckdb::keyGetNameSize(key.getKey())) - 1;
+    char const *value = ckdb::keyString(key.getKey());
+    ssize_t const valueSize = ckdb::keyGetValueSize(key.getKey());
+    size_t const size = valueSize > 1 ? static_cast<size_t>(valueSize) - 1 : 0;
+
+    switch (format) {
+    case Format::LISTING:
+      output.append(name, nameSize);
+      output.append(':');
+      if (size > 0) {
+        output.append(' ');
+        output.append(value, size);
+      }
+      output.append('\n');
+      break;
+    case Format::JSON:
+      output.append("{\"name\":\"", 9);
+      appendJson(output, name, nameSize);
+      output.append("\",\"value\":\"", 11);
+      appendJson(output, value, size);
+      output.append("\"}\n", 3);
+      break;
+    case Format::NUL:
+      output.append(name, nameSize + 1);
+      output.append(value, size);
+      output.append('\0');
+      break;
+    }
+  }
+}
+
+/**
+ * @brief This function reads the number of a command line option of the
+ *        form `prefix` followed by a number.
+ *
+ * @param argument This parameter stores the command line argument.
+ * @param prefix This parameter specifies the name of the option including the
+ *               equal sign.
+ * @param number The function stores the parsed number in this variable.
+ *
+ * @retval true If `argument` starts with `prefix` followed by a number
+ * @retval false Otherwise
+ */
+bool readNumber(string const &argument, string const &prefix, int &number) {
+  if (argument.compare(0, prefix.size(), prefix) != 0 ||
+      argument.size() <= prefix.size()) {
+    return false;
+  }
+  size_t end;
+  try {
+    number = stoi(argument.substr(prefix.size()), &end);
+  } catch (logic_error const &) {
+    return false;
+  }
+  return end == argument.size() - prefix.size();
+}
+
+/**
+ * @brief This function reads the whole content of a file.
+ *
+ * @param filename This parameter stores the path of the file.
+ * @param text The function stores the content of the file in this variable.
+ *
+ * @retval true If the function was able to read the file
+ * @retval false Otherwise
+ */
+bool readFile(string const &filename, string &text) {
+  ifstream input{filename};
+  if (!input.is_open()) {
+    return false;
+  }
+  text.assign(istreambuf_iterator<char>{input}, istreambuf_iterator<char>{});
+  return !input.bad();
+}
+
+/**
+ * @brief This function converts the previous version of a YAML file and then
+ *        updates the keys to match the current version of the file.
+ *
+ * The changed range of the file is the part between the longest common
+ * prefix and the longest common suffix of both versions.
+ *
+ * @param keys The function adds the converted keys to this variable.
+ * @param parent The function uses this key as parent of the converted keys
+ *               and to emit error information.
+ * @param previous This parameter stores the path of the previous version of
+ *                 the YAML file.
+ * @param filename This parameter stores the path of the current version of
+ *                 the YAML file.
+ * @param options This argument stores settings that change how the function
+ *                reads the YAML files.
+ *
+ * @retval -3 if the caller cancelled the conversion
+ * @retval -2 if one of the files could not be opened for reading
+ * @retval -1 if there was a error converting one of the YAML files
+ * @retval  0 if parsing was successful
+ */
+int updateFrom(KeySet &keys, Key &parent, string const &previous,
+               string const &filename, Options const &options) {
+  vector<Block> blocks;
+  int const status = addToKeySet(keys, parent, previous, blocks, options);
+  if (status < 0) {
+    return status;
+  }
+
+  string oldText;
+  string newText;
+  if (!readFile(previous, oldText) || !readFile(filename, newText)) {
+    cerr << "Unable to read “" << previous << "” and “" << filename << "”"
+         << endl;
+    return -2;
+  }
+  size_t const limit = min(oldText.size(), newText.size());
+  size_t begin = 0;
+  while (begin < limit && oldText[begin] == newText[begin]) {
+    begin++;
+  }
+  size_t suffix = 0;
+  while (suffix < limit - begin &&
+         oldText[oldText.size() - 1 - suffix] ==
+             newText[newText.size() - 1 - suffix]) {
+    suffix++;
   }
+  Edit const edit{begin, oldText.size() - suffix, newText.size() - suffix};
+  return updateKeySet(keys, parent, filename, blocks, edit, options);
 }
 
 // -- Main ---------------------------------------------------------------------
 
 int main(int argc, char const *argv[]) {
-  if (argc < 2) {
-    cerr << "Usage: " << argv[0] << " filename" << endl;
+  // All other options override the settings of the production profile
+  bool const production =
+      find(argv + 1, argv + argc, string("--production")) != argv + argc;
+  Options options = production ? Options::production() : Options{};
+  Statistics statistics;
+  Cancellation cancellation;
+  bool check = false;
+  bool documents = false;
+  bool trie = false;
+  Format format = Format::LISTING;
+  string filter;
+  string filename;
+  string snapshot;
+  string sourceSnapshot;
+  string previous;
+  Digest digest;
+
+  for (int index = 1; index < argc; index++) {
+    string const argument = argv[index];
+    int number;
+    if (argument == "--skip-comments") {
+      options.skipComments = true;
+    } else if (argument == "--stats") {
+      options.statistics = &statistics;
+    } else if (argument == "--syntax-tree") {
+      options.printSyntaxTree = true;
+    } else if (argument.compare(0, 9, "--filter=") == 0) {
+      filter = argument.substr(9);
+    } else if (argument.compare(0, 11, "--snapshot=") == 0) {
+      snapshot = argument.substr(11);
+      options.digest = &digest;
+    } else if (argument.compare(0, 16, "--from-snapshot=") == 0) {
+      sourceSnapshot = argument.substr(16);
+    } else if (argument.compare(0, 14, "--update-from=") == 0) {
+      previous = argument.substr(14);
+    } else if (argument == "--check") {
+      check = true;
+    } else if (argument == "--documents") {
+      documents = true;
+    } else if (argument == "--trie") {
+      trie = true;
+    } else if (argument == "--format=listing") {
+      format = Format::LISTING;
+    } else if (argument == "--format=json") {
+      format = Format::JSON;
+    } else if (argument == "--format=nul") {
+      format = Format::NUL;
+    } else if (argument == "--production") {
+      continue;
+    } else if (readNumber(argument, "--lookahead-level=", number) &&
+               number >= 0 && number <= 2) {
+      options.lookaheadLevel = number;
+    } else if (argument == "--all-parses") {
+      options.oneParse = false;
+    } else if (argument == "--cost") {
+      options.cost = true;
+    } else if (argument == "--no-error-recovery") {
+      options.errorRecovery = false;
+    } else if (readNumber(argument, "--recovery-match=", number) &&
+               number >= 0) {
+      options.recoveryMatch = number;
+    } else if (argument == "--no-ambiguity-check") {
+      options.checkAmbiguity = false;
+    } else if (readNumber(argument, "--threads=", number) && number >= 0) {
+      options.threads = static_cast<size_t>(number);
+    } else if (argument == "--pipeline") {
+      options.pipeline = true;
+    } else if (readNumber(argument, "--max-bytes=", number) && number >= 0) {
+      options.maxBytes = static_cast<size_t>(number);
+    } else if (readNumber(argument, "--max-depth=", number) && number >= 0) {
+      options.maxDepth = static_cast<size_t>(number);
+    } else if (readNumber(argument, "--max-scalar-length=", number) &&
+               number >= 0) {
+      options.maxScalarLength = static_cast<size_t>(number);
+    } else if (readNumber(argument, "--max-tokens=", number) && number >= 0) {
+      options.maxTokens = static_cast<size_t>(number);
+    } else if (readNumber(argument, "--max-keys=", number) && number >= 0) {
+      options.maxKeys = static_cast<size_t>(number);
+    } else if (readNumber(argument, "--timeout=", number) && number >= 0) {
+      cancellation.setDeadline(Cancellation::Clock::now() +
+                               milliseconds(number));
+      options.cancellation = &cancellation;
+    } else if (argument.compare(0, 2, "--") != 0 && filename.empty()) {
+      filename = argument;
+    } else {
+      filename.clear();
+      break;
+    }
+  }
+
+  // Only a conversion records the size and hash of the text for a snapshot
+  if (!snapshot.empty() &&
+      (!sourceSnapshot.empty() || !previous.empty() || check)) {
+    filename.clear();
+  }
+
+  if (filename.empty()) {
+    string const indent(string{"Usage: "}.size() + string{argv[0]}.size(),
+                        ' ');
+    cerr << "Usage: " << argv[0] << " [--check] [--skip-comments] [--stats]"
+         << endl
+         << indent << " [--syntax-tree] [--documents] [--production]" << endl
+         << indent << " [--lookahead-level=0|1|2] [--all-parses] [--cost]"
+         << endl
+         << indent << " [--no-error-recovery] [--recovery-match=number]"
+         << endl
+         << indent << " [--no-ambiguity-check] [--threads=number] [--pipeline]"
+         << endl
+         << indent << " [--filter=path] [--max-bytes=number]"
+         << " [--max-depth=number]" << endl
+         << indent << " [--max-scalar-length=number] [--max-tokens=number]"
+         << endl
+         << indent << " [--max-keys=number] [--timeout=milliseconds]" << endl
+         << indent << " [--snapshot=path] [--from-snapshot=path]" << endl
+         << indent << " [--update-from=path]" << endl
+         << indent << " [--format=listing|json|nul] [--trie]" << endl
+         << indent << " filename" << endl;
     return EXIT_FAILURE;
   }
 
-  string filename = argv[1];
+  if (check) {
+    Location location;
+    string message;
+    int status = validate(filename, location, message, options);
+    if (status == -1) {
+      cerr << filename << ":" << location.begin.line << ":"
+           << location.begin.column << ": " << message;
+    } else if (status == -3) {
+      cerr << "Validation of “" << filename << "” exceeded the timeout";
+    }
+    if (options.statistics) {
+      cerr << endl << to_string(statistics);
+    }
+    return (status >= 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+  }
+
   KeySet keys;
   Key parent{keyNew("user", KEY_END, "", KEY_VALUE)};
 
-  int status = addToKeySet(keys, parent, filename);
-  printOutput(keys);
+  int status;
+  if (!sourceSnapshot.empty()) {
+    status = loadSnapshot(keys, parent, filename, sourceSnapshot);
+  } else if (!previous.empty()) {
+    status = updateFrom(keys, parent, previous, filename, options);
+  } else if (documents) {
+    // Print the keys of each document as soon as the converter finished it.
+    // A snapshot still needs the keys of all documents.
+    bool const collect = !snapshot.empty();
+    status = forEachDocument(
+        parent, filename,
+        [format, collect, &keys](KeySet &documentKeys) {
+          printOutput(documentKeys, format);
+          if (collect) {
+            keys.append(documentKeys);
+          }
+        },
+        options);
+  } else if (trie) {
+    KeyTrie keyTrie{parent, options.maxKeys};
+    status = addToTrie(keyTrie, filename, options);
+    keys.append(keyTrie.getKeySet());
+  } else {
+    status = filter.empty()
+                 ? addToKeySet(keys, parent, filename, options)
+                 : addToKeySet(keys, parent, filename, filter, options);
+  }
+  if (status >= 0 && !snapshot.empty()) {
+    status = writeSnapshot(keys, parent, digest, snapshot);
+  }
+  if (status == -3) {
+    cerr << "Conversion of “" << filename << "” exceeded the timeout" << endl;
+  }
+  if (!documents) {
+    printOutput(keys, format);
+  }
+  if (options.statistics) {
+    cerr << endl << to_string(statistics);
+  }
   return (status >= 0) ? EXIT_SUCCESS : EXIT_FAILURE;
 }
@@ -0,0 +1,42 @@
+#!/usr/bin/env fish
+
+# This script compares the time YAEP needs to parse a generated YAML file for
+# different settings of the parsing engine.
+
+set parser "Build/yawn"
+set repetitions 5
+trap cleanup EXIT INT QUIT TERM
+
+function cleanup -d 'Remove temporary files'
+    rm -f "$input"
+end
+
+set input (mktemp)
+seq 1000 | awk '{
+    printf "key%s:\n", $1
+    for (element = 1; element <= 10; element++)
+        printf "  - value %s\n", element
+}' >"$input"
+
+set configurations '' '--production' '--lookahead-level=0' \
+    '--lookahead-level=2' '--all-parses' '--cost' '--no-error-recovery' \
+    '--no-ambiguity-check'
+
+printf "Average parser time of %s runs in µs\n\n" "$repetitions"
+for configuration in $configurations
+    set -l times
+    for repetition in (seq $repetitions)
+        set -l statistics (eval $parser --stats $configuration "\"$input\"" \
+            2>&1 >/dev/null)
+        if test "$status" -ne 0
+            printf "Unable to parse input using “%s”\n" "$configuration" >&2
+            exit 1
+        end
+        set -a times (string match -r 'Parser\s+(\d+)' -- $statistics)[2]
+    end
+    if test -z "$configuration"
+        set configuration 'default'
+    end
+    printf "%-24s %12s\n" "$configuration" \
+        (math "("(string join + $times)") / $repetitions")
+end
@@ -9,26 +9,102 @@ end
 
 set IFS (printf '\n\b')
 for file in (find Input -depth 1 -type file -name '*.yaml' | sort)
-    printf "• Test file “%s”\n" "$file"
+    for options in '' '--skip-comments' '--stats' '--threads=4' \
+        '--pipeline' '--trie'
+        printf "• Test file “%s” %s\n" "$file" "$options"
 
-    set output (mktemp)
-    set -l error_message (eval $parser "\"$file\"" 2>&1 >"$output")
+        set output (mktemp)
+        set -l error_message (eval $parser $options "\"$file\"" 2>&1 >"$output")
+        if test "$status" -ne 0
+            printf "\nUnable to parse “%s”:\n\n" "$file" >&2
+            printf '%s\n\n' "$error_message" >&2
+            set failed 'true'
+            continue
+        end
+
+        perl -0777pe 's/.*— Output ————\n\n(.*)/\1/sm' -i "$output"
+        set difference (mktemp)
+        set -l expected (printf "$file" | sed 's/\.[^.]*$/.txt/')
+        if ! diff --side-by-side "$output" "$expected" >"$difference"
+            printf "\nThe output for “%s” did not match the expected output:\n\n" "$file" >&2
+            cat "$difference" >&2
+            set failed 'true'
+        end
+    end
+
+    for format in 'json' 'nul'
+        set -l expected (printf "$file" | sed "s/\.[^.]*\$/.$format/")
+        if ! test -f "$expected"
+            continue
+        end
+        printf "• Test file “%s” --format=%s\n" "$file" "$format"
+
+        set output (mktemp)
+        eval $parser --format=$format "\"$file\"" >"$output" 2>/dev/null
+        if test "$status" -ne 0; or ! cmp -s "$output" "$expected"
+            printf "\nThe %s output for “%s” did not match the expected output\n\n" "$format" "$file" >&2
+            set failed 'true'
+        end
+    end
+
+    printf "• Check file “%s”\n" "$file"
+    set -l error_message (eval $parser --check "\"$file\"" 2>&1)
     if test "$status" -ne 0
-        printf "\nUnable to parse “%s”:\n\n" "$file" >&2
+        printf "\nUnable to validate “%s”:\n\n" "$file" >&2
         printf '%s\n\n' "$error_message" >&2
         set failed 'true'
-        continue
     end
 
-    perl -0777pe 's/.*— Output ————\n\n(.*)/\1/sm' -i "$output"
-    set difference (mktemp)
-    set -l expected (printf "$file" | sed 's/\.[^.]*$/.txt/')
-    if ! diff --side-by-side "$output" "$expected" >"$difference"
-        printf "\nThe output for “%s” did not match the expected output:\n\n" "$file" >&2
-        cat "$difference" >&2
+    printf "• Snapshot file “%s”\n" "$file"
+    set -l snapshot (mktemp)
+    set -l converted (mktemp)
+    set -l loaded (mktemp)
+    eval $parser --snapshot="\"$snapshot\"" "\"$file\"" >"$converted" 2>&1
+    and eval $parser --from-snapshot="\"$snapshot\"" "\"$file\"" >"$loaded" 2>&1
+    and diff "$converted" "$loaded" >/dev/null
+    if test "$status" -ne 0
+        printf "\nThe keys loaded from the snapshot of “%s” did not match the converted keys\n\n" "$file" >&2
+        set failed 'true'
+    end
+
+    eval $parser --documents --snapshot="\"$snapshot\"" "\"$file\"" >/dev/null 2>&1
+    and eval $parser --from-snapshot="\"$snapshot\"" "\"$file\"" >"$loaded" 2>&1
+    and diff "$converted" "$loaded" >/dev/null
+    if test "$status" -ne 0
+        printf "\nThe keys loaded from the document snapshot of “%s” did not match the converted keys\n\n" "$file" >&2
+        set failed 'true'
+    end
+    rm -f "$snapshot" "$converted" "$loaded"
+end
+
+printf "• Read size limited input from a pipe\n"
+set -l error_message (cat Input/Documents.yaml | eval $parser --max-bytes=100000 /dev/stdin 2>&1 >/dev/null)
+if test "$status" -ne 0
+    printf "\nUnable to parse input from a pipe:\n\n" >&2
+    printf '%s\n\n' "$error_message" >&2
+    set failed 'true'
+end
+if cat Input/Documents.yaml | eval $parser --max-bytes=10 /dev/stdin >/dev/null 2>&1
+    printf "\nThe parser accepted input from a pipe above the size limit\n\n" >&2
+    set failed 'true'
+end
+
+set -l original 'Input/Map>Map>Plain Scalars.yaml'
+set -l edited (mktemp)
+set -l updated (mktemp)
+set -l converted (mktemp)
+for edit in 's/  e: f/  e: changed/' 's/^d:/# Comment\nd:/' 's/^d:/renamed:/'
+    printf "• Update keys of “%s” after the edit “%s”\n" "$original" "$edit"
+    perl -pe "$edit" "$original" >"$edited"
+    eval $parser --update-from="\"$original\"" "\"$edited\"" >"$updated" 2>&1
+    and eval $parser "\"$edited\"" >"$converted" 2>&1
+    and diff "$updated" "$converted" >/dev/null
+    if test "$status" -ne 0
+        printf "\nThe updated keys for the edit “%s” did not match the converted keys\n\n" "$edit" >&2
         set failed 'true'
     end
 end
+rm -f "$edited" "$updated" "$converted"
 
 if test "$failed" = 'true'
     exit 1